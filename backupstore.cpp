@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <unordered_set>
+
+#include "backupstore.h"
+#include "sha256.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Table du hachage gear : 256 valeurs pseudo-aléatoires fixes (splitmix64).
+// Elle ne doit pas changer : les frontières des morceaux, donc la
+// déduplication avec les anciennes générations, en dépendent.
+static array<uint64_t, 256> makeGearTable() {
+    array<uint64_t, 256> table{};
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (uint64_t& value : table) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+static const array<uint64_t, 256> GEAR = makeGearTable();
+
+BackupStore::BackupStore(const string& directory) : directory(directory) {}
+
+string BackupStore::chunkPath(const string& hash) const {
+    return (fs::path(directory) / "chunks" / hash.substr(0, 2) / hash).string();
+}
+
+string BackupStore::manifestPath(int number) const {
+    string name = to_string(number);
+    name.insert(0, name.size() < 6 ? 6 - name.size() : 0, '0');
+    return (fs::path(directory) / "manifests" / (name + ".txt")).string();
+}
+
+// ---- Découpage ----
+
+bool BackupStore::chunkFile(const string& path, const function<void(const char* data, size_t length)>& emit) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return false;
+
+    vector<char> buffer(1 << 20);
+    string carry;       // début du morceau en cours, lu au tour précédent
+    uint64_t hash = 0;  // chaque bit dépend au plus des 64 derniers octets
+    size_t chunkLength = 0;
+
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        size_t count = static_cast<size_t>(file.gcount());
+        size_t start = 0;
+        for (size_t i = 0; i < count; ++i) {
+            hash = (hash << 1) + GEAR[static_cast<uint8_t>(buffer[i])];
+            chunkLength++;
+            // frontière quand les AVERAGE_BITS bits de poids fort sont nuls
+            bool boundary = (chunkLength >= MIN_CHUNK && (hash >> (64 - AVERAGE_BITS)) == 0) ||
+                            chunkLength >= MAX_CHUNK;
+            if (!boundary) continue;
+
+            if (carry.empty()) {
+                emit(buffer.data() + start, i + 1 - start);
+            } else {
+                carry.append(buffer.data() + start, i + 1 - start);
+                emit(carry.data(), carry.size());
+                carry.clear();
+            }
+            start = i + 1;
+            chunkLength = 0;
+            hash = 0;
+        }
+        carry.append(buffer.data() + start, count - start);
+    }
+    if (file.bad()) return false;
+    if (!carry.empty()) emit(carry.data(), carry.size());
+    return true;
+}
+
+// ---- Morceaux ----
+
+// Write a chunk unless it is already stored (written aside, then renamed)
+bool BackupStore::storeChunk(const string& hash, const char* data, size_t length, bool& added) const {
+    added = false;
+    string path = chunkPath(hash);
+    error_code ec;
+    if (fs::exists(path, ec)) return true;
+
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    string temporary = path + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    file.write(data, static_cast<streamsize>(length));
+    file.close();
+    if (!file) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    fs::rename(temporary, path, ec);
+    added = !ec;
+    return !ec;
+}
+
+// Read a chunk and check its length and hash
+bool BackupStore::readChunk(const ChunkRef& chunk, string& data) const {
+    ifstream file(chunkPath(chunk.hash), ios::binary);
+    if (!file.is_open()) return false;
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    return data.size() == chunk.length && Sha256::hash(data.data(), data.size()) == chunk.hash;
+}
+
+// ---- Manifestes ----
+// generation|42
+// created|1760000000
+// file|books.txt|<taille>|<date>
+// chunk|<sha256>|<longueur>      (morceaux du fichier précédent, dans l'ordre)
+
+bool BackupStore::writeManifest(const Generation& generation) const {
+    string path = manifestPath(generation.number);
+    error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+
+    string temporary = path + ".tmp";
+    ofstream file(temporary, ios::trunc);
+    file << "generation|" << generation.number << "\n";
+    file << "created|" << generation.created << "\n";
+    for (const FileEntry& entry : generation.files) {
+        file << "file|" << entry.name << "|" << entry.size << "|" << entry.modified << "\n";
+        for (const ChunkRef& chunk : entry.chunks) {
+            file << "chunk|" << chunk.hash << "|" << chunk.length << "\n";
+        }
+    }
+    file.close();
+    if (!file) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    // le manifeste arrive en dernier : une génération interrompue n'existe pas
+    fs::rename(temporary, path, ec);
+    return !ec;
+}
+
+bool BackupStore::loadGeneration(int number, Generation& generation) const {
+    ifstream file(manifestPath(number));
+    if (!file.is_open()) return false;
+
+    generation = Generation();
+    string line;
+    try {
+        while (getline(file, line)) {
+            vector<string> fields;
+            stringstream ss(line);
+            string field;
+            while (getline(ss, field, '|')) fields.push_back(field);
+            if (fields.empty()) continue;
+
+            if (fields[0] == "generation" && fields.size() == 2) {
+                generation.number = stoi(fields[1]);
+            } else if (fields[0] == "created" && fields.size() == 2) {
+                generation.created = static_cast<time_t>(stoll(fields[1]));
+            } else if (fields[0] == "file" && fields.size() == 4) {
+                // nom simple seulement : une restauration n'écrit jamais ailleurs
+                if (fields[1].empty() || fields[1] == "." || fields[1] == ".." ||
+                    fields[1].find_first_of("/\\") != string::npos) {
+                    return false;
+                }
+                FileEntry entry;
+                entry.name = fields[1];
+                entry.size = stoull(fields[2]);
+                entry.modified = stoll(fields[3]);
+                generation.files.push_back(move(entry));
+            } else if (fields[0] == "chunk" && fields.size() == 3 && !generation.files.empty() &&
+                       fields[1].size() == 64 && all_of(fields[1].begin(), fields[1].end(), ::isxdigit)) {
+                generation.files.back().chunks.push_back({fields[1], stoull(fields[2])});
+            } else {
+                return false;
+            }
+        }
+    } catch (const exception&) {
+        return false; // nombre illisible
+    }
+    return generation.number == number;
+}
+
+// Numbers of the manifests found in manifests/, in increasing order
+vector<int> BackupStore::generationNumbers() const {
+    vector<int> numbers;
+    error_code ec;
+    for (const auto& item : fs::directory_iterator(fs::path(directory) / "manifests", ec)) {
+        string stem = item.path().stem().string();
+        if (item.path().extension() == ".txt" && !stem.empty() && stem.size() <= 9 &&
+            all_of(stem.begin(), stem.end(), ::isdigit)) {
+            numbers.push_back(stoi(stem));
+        }
+    }
+    sort(numbers.begin(), numbers.end());
+    return numbers;
+}
+
+vector<BackupStore::Generation> BackupStore::listGenerations() const {
+    vector<Generation> generations;
+    for (int number : generationNumbers()) {
+        Generation generation;
+        if (loadGeneration(number, generation)) generations.push_back(move(generation));
+    }
+    return generations;
+}
+
+// ---- Sauvegarde, restauration, vérification ----
+
+BackupStore::BackupReport BackupStore::backup(const vector<string>& paths) {
+    BackupReport report;
+    vector<int> numbers = generationNumbers();
+    Generation previous;
+    bool hasPrevious = !numbers.empty() && loadGeneration(numbers.back(), previous);
+
+    Generation generation;
+    generation.number = numbers.empty() ? 1 : numbers.back() + 1;
+    generation.created = time(nullptr);
+
+    for (const string& path : paths) {
+        error_code ec;
+        if (!fs::is_regular_file(path, ec)) continue;
+
+        FileEntry entry;
+        entry.name = fs::path(path).filename().string();
+        entry.size = fs::file_size(path, ec);
+        entry.modified = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+
+        // inchangé depuis la génération précédente : mêmes morceaux, sans relire
+        const FileEntry* same = nullptr;
+        if (hasPrevious) {
+            for (const FileEntry& old : previous.files) {
+                if (old.name == entry.name && old.size == entry.size && old.modified == entry.modified) same = &old;
+            }
+        }
+
+        if (same) {
+            entry.chunks = same->chunks;
+        } else {
+            bool stored = true;
+            entry.size = 0;
+            bool read = chunkFile(path, [&](const char* data, size_t length) {
+                string hash = Sha256::hash(data, length);
+                bool added;
+                if (!storeChunk(hash, data, length, added)) stored = false;
+                if (added) {
+                    report.newChunks++;
+                    report.newBytes += length;
+                }
+                entry.chunks.push_back({hash, length});
+                entry.size += length;
+            });
+            if (!read || !stored) return BackupReport();
+        }
+
+        report.files++;
+        report.chunks += entry.chunks.size();
+        report.bytes += entry.size;
+        generation.files.push_back(move(entry));
+    }
+
+    if (!writeManifest(generation)) return BackupReport();
+    report.generation = generation.number;
+    return report;
+}
+
+bool BackupStore::restore(int number, const string& targetDirectory, string& error) const {
+    Generation generation;
+    if (!loadGeneration(number, generation)) {
+        error = "génération " + to_string(number) + " introuvable ou illisible";
+        return false;
+    }
+
+    // chaque fichier est reconstruit à côté ; rien n'est remplacé avant la fin
+    vector<pair<string, string>> rebuilt; // (temporaire, destination)
+    auto discard = [&rebuilt]() {
+        error_code ec;
+        for (const auto& file : rebuilt) fs::remove(file.first, ec);
+    };
+
+    string data;
+    for (const FileEntry& entry : generation.files) {
+        string target = (fs::path(targetDirectory) / entry.name).string();
+        string temporary = target + ".restauration";
+        rebuilt.emplace_back(temporary, target);
+
+        ofstream file(temporary, ios::binary | ios::trunc);
+        for (const ChunkRef& chunk : entry.chunks) {
+            if (!readChunk(chunk, data)) {
+                error = "morceau " + chunk.hash + " de " + entry.name + " absent ou endommagé";
+                file.close();
+                discard();
+                return false;
+            }
+            file.write(data.data(), static_cast<streamsize>(data.size()));
+        }
+        file.close();
+        if (!file) {
+            error = "impossible d'écrire " + temporary;
+            discard();
+            return false;
+        }
+    }
+
+    for (const auto& file : rebuilt) {
+        error_code ec;
+        fs::rename(file.first, file.second, ec);
+        if (ec) {
+            error = "impossible de remplacer " + file.second + " : " + ec.message();
+            discard();
+            return false;
+        }
+    }
+    return true;
+}
+
+BackupStore::VerifyReport BackupStore::verify() const {
+    VerifyReport report;
+    unordered_set<string> checked;
+    string data;
+
+    for (int number : generationNumbers()) {
+        Generation generation;
+        if (!loadGeneration(number, generation)) {
+            report.problems.push_back("manifeste " + manifestPath(number) + " illisible");
+            continue;
+        }
+        report.generations++;
+        for (const FileEntry& entry : generation.files) {
+            for (const ChunkRef& chunk : entry.chunks) {
+                if (!checked.insert(chunk.hash).second) continue; // partagé : déjà vérifié
+                report.chunks++;
+                if (!readChunk(chunk, data)) {
+                    report.problems.push_back("génération " + to_string(number) + ", " + entry.name +
+                                              " : morceau " + chunk.hash + " absent ou endommagé");
+                }
+            }
+        }
+    }
+    return report;
+}
@@ -0,0 +1,93 @@
+#ifndef BACKUPSTORE_H
+#define BACKUPSTORE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+
+using namespace std;
+
+// Sauvegardes incrémentales avec déduplication.
+// Chaque fichier est découpé en morceaux dont les frontières dépendent du
+// contenu (hachage « gear » glissant) : une insertion au milieu d'un fichier
+// ne déplace que les morceaux voisins. Chaque morceau est rangé une seule
+// fois sous son empreinte SHA-256 :
+//   <dossier>/chunks/ab/abcdef...    morceaux partagés par toutes les générations
+//   <dossier>/manifests/000042.txt   liste des fichiers et morceaux d'une génération
+// Une génération ne coûte donc que les morceaux nouveaux. Un fichier dont la
+// taille et la date n'ont pas changé depuis la génération précédente n'est
+// même pas relu.
+class BackupStore {
+public:
+    // Taille des morceaux : minimum, moyenne visée (2^13) et maximum
+    static const size_t MIN_CHUNK = 2 * 1024;
+    static const size_t MAX_CHUNK = 64 * 1024;
+    static const int AVERAGE_BITS = 13;
+
+    struct ChunkRef {
+        string hash;
+        uint64_t length;
+    };
+
+    struct FileEntry {
+        string name;      // nom du fichier, sans dossier
+        uint64_t size = 0;
+        int64_t modified = 0;
+        vector<ChunkRef> chunks;
+    };
+
+    struct Generation {
+        int number = 0;
+        time_t created = 0;
+        vector<FileEntry> files;
+    };
+
+    struct BackupReport {
+        int generation = 0;
+        size_t files = 0;
+        size_t chunks = 0;
+        size_t newChunks = 0;
+        uint64_t bytes = 0;
+        uint64_t newBytes = 0;   // octets réellement écrits dans chunks/
+    };
+
+    struct VerifyReport {
+        size_t generations = 0;
+        size_t chunks = 0;       // morceaux distincts vérifiés
+        vector<string> problems; // morceaux absents ou endommagés, manifestes illisibles
+    };
+
+    explicit BackupStore(const string& directory);
+
+    // Nouvelle génération avec les fichiers donnés (ceux qui n'existent pas
+    // sont ignorés) ; generation vaut 0 en cas d'échec
+    BackupReport backup(const vector<string>& paths);
+
+    // Générations existantes, de la plus ancienne à la plus récente
+    vector<Generation> listGenerations() const;
+    bool loadGeneration(int number, Generation& generation) const;
+
+    // Reconstruit les fichiers d'une génération dans targetDirectory. Tous les
+    // morceaux sont relus et vérifiés avant de remplacer quoi que ce soit.
+    bool restore(int number, const string& targetDirectory, string& error) const;
+
+    // Relit tous les morceaux référencés et compare leur empreinte
+    VerifyReport verify() const;
+
+    // Découpe un fichier en morceaux définis par le contenu
+    static bool chunkFile(const string& path, const function<void(const char* data, size_t length)>& emit);
+
+private:
+    string directory;
+
+    string chunkPath(const string& hash) const;
+    string manifestPath(int number) const;
+    vector<int> generationNumbers() const;
+    bool storeChunk(const string& hash, const char* data, size_t length, bool& added) const;
+    bool readChunk(const ChunkRef& chunk, string& data) const;
+    bool writeManifest(const Generation& generation) const;
+};
+
+#endif
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <iterator>
+
+#include "bitmap.h"
+
+using namespace std;
+
+static const size_t BITSET_WORDS = 65536 / 64;
+
+// ---- Conteneurs ----
+
+bool RoaringBitmap::Container::contains(uint16_t low) const {
+    if (isBitset()) {
+        return (bits[low >> 6] >> (low & 63)) & 1;
+    }
+    return binary_search(array.begin(), array.end(), low);
+}
+
+void RoaringBitmap::Container::add(uint16_t low) {
+    if (isBitset()) {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (!(bits[low >> 6] & mask)) {
+            bits[low >> 6] |= mask;
+            cardinality++;
+        }
+        return;
+    }
+    auto it = lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) return;
+    array.insert(it, low);
+    cardinality++;
+    if (cardinality > ARRAY_LIMIT) toBitset();
+}
+
+void RoaringBitmap::Container::remove(uint16_t low) {
+    if (isBitset()) {
+        uint64_t mask = uint64_t(1) << (low & 63);
+        if (bits[low >> 6] & mask) {
+            bits[low >> 6] &= ~mask;
+            cardinality--;
+            if (cardinality <= ARRAY_LIMIT) toArray();
+        }
+        return;
+    }
+    auto it = lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        array.erase(it);
+        cardinality--;
+    }
+}
+
+void RoaringBitmap::Container::toBitset() {
+    bits.assign(BITSET_WORDS, 0);
+    for (uint16_t low : array) bits[low >> 6] |= uint64_t(1) << (low & 63);
+    vector<uint16_t>().swap(array);
+}
+
+void RoaringBitmap::Container::toArray() {
+    array.clear();
+    array.reserve(cardinality);
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word) {
+            array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+    vector<uint64_t>().swap(bits);
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container& a, const Container& b) {
+    Container result;
+    if (a.isBitset() && b.isBitset()) {
+        result.bits.resize(BITSET_WORDS);
+        for (size_t w = 0; w < BITSET_WORDS; ++w) {
+            result.bits[w] = a.bits[w] & b.bits[w];
+            result.cardinality += __builtin_popcountll(result.bits[w]);
+        }
+        if (result.cardinality <= ARRAY_LIMIT) result.toArray();
+    } else if (a.isBitset() || b.isBitset()) {
+        const Container& arr = a.isBitset() ? b : a;
+        const Container& set = a.isBitset() ? a : b;
+        for (uint16_t low : arr.array) {
+            if (set.contains(low)) result.array.push_back(low);
+        }
+        result.cardinality = result.array.size();
+    } else {
+        set_intersection(a.array.begin(), a.array.end(),
+                         b.array.begin(), b.array.end(),
+                         back_inserter(result.array));
+        result.cardinality = result.array.size();
+    }
+    return result;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container& a, const Container& b) {
+    Container result;
+    if (a.isBitset() || b.isBitset()) {
+        result.bits.assign(BITSET_WORDS, 0);
+        for (const Container* c : {&a, &b}) {
+            if (c->isBitset()) {
+                for (size_t w = 0; w < BITSET_WORDS; ++w) result.bits[w] |= c->bits[w];
+            } else {
+                for (uint16_t low : c->array) result.bits[low >> 6] |= uint64_t(1) << (low & 63);
+            }
+        }
+        for (uint64_t word : result.bits) result.cardinality += __builtin_popcountll(word);
+    } else {
+        set_union(a.array.begin(), a.array.end(),
+                  b.array.begin(), b.array.end(),
+                  back_inserter(result.array));
+        result.cardinality = result.array.size();
+        if (result.cardinality > ARRAY_LIMIT) result.toBitset();
+    }
+    return result;
+}
+
+// ---- Bitmap ----
+
+size_t RoaringBitmap::findKey(uint16_t key) const {
+    return lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+void RoaringBitmap::add(uint32_t value) {
+    uint16_t key = value >> 16;
+    size_t i = findKey(key);
+    if (i == keys.size() || keys[i] != key) {
+        keys.insert(keys.begin() + i, key);
+        containers.insert(containers.begin() + i, Container());
+    }
+    containers[i].add(value & 0xFFFF);
+}
+
+void RoaringBitmap::remove(uint32_t value) {
+    uint16_t key = value >> 16;
+    size_t i = findKey(key);
+    if (i == keys.size() || keys[i] != key) return;
+    containers[i].remove(value & 0xFFFF);
+    if (containers[i].cardinality == 0) {
+        keys.erase(keys.begin() + i);
+        containers.erase(containers.begin() + i);
+    }
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    uint16_t key = value >> 16;
+    size_t i = findKey(key);
+    return i < keys.size() && keys[i] == key && containers[i].contains(value & 0xFFFF);
+}
+
+void RoaringBitmap::clear() {
+    keys.clear();
+    containers.clear();
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t total = 0;
+    for (const Container& c : containers) total += c.cardinality;
+    return total;
+}
+
+bool RoaringBitmap::empty() const { return keys.empty(); }
+
+size_t RoaringBitmap::heapBytes() const {
+    size_t bytes = keys.capacity() * sizeof(uint16_t) + containers.capacity() * sizeof(Container);
+    for (const Container& c : containers) {
+        bytes += c.array.capacity() * sizeof(uint16_t) + c.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+RoaringBitmap RoaringBitmap::range(uint32_t count) {
+    RoaringBitmap result;
+    for (uint32_t start = 0; start < count; start += 65536) {
+        uint32_t end = min<uint32_t>(count, start + 65536);
+        Container c;
+        if (end - start > ARRAY_LIMIT) {
+            c.bits.assign(BITSET_WORDS, 0);
+            for (uint32_t v = start; v < end; ++v) {
+                uint16_t low = v & 0xFFFF;
+                c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+            }
+        } else {
+            for (uint32_t v = start; v < end; ++v) c.array.push_back(v & 0xFFFF);
+        }
+        c.cardinality = end - start;
+        result.keys.push_back(start >> 16);
+        result.containers.push_back(move(c));
+    }
+    return result;
+}
+
+RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < a.keys.size() && j < b.keys.size()) {
+        if (a.keys[i] < b.keys[j]) {
+            ++i;
+        } else if (a.keys[i] > b.keys[j]) {
+            ++j;
+        } else {
+            RoaringBitmap::Container c = RoaringBitmap::intersect(a.containers[i], b.containers[j]);
+            if (c.cardinality > 0) {
+                result.keys.push_back(a.keys[i]);
+                result.containers.push_back(move(c));
+            }
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < a.keys.size() || j < b.keys.size()) {
+        if (j == b.keys.size() || (i < a.keys.size() && a.keys[i] < b.keys[j])) {
+            result.keys.push_back(a.keys[i]);
+            result.containers.push_back(a.containers[i]);
+            ++i;
+        } else if (i == a.keys.size() || b.keys[j] < a.keys[i]) {
+            result.keys.push_back(b.keys[j]);
+            result.containers.push_back(b.containers[j]);
+            ++j;
+        } else {
+            result.keys.push_back(a.keys[i]);
+            result.containers.push_back(RoaringBitmap::unite(a.containers[i], b.containers[j]));
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+vector<uint32_t> RoaringBitmap::toVector() const {
+    vector<uint32_t> values;
+    values.reserve(cardinality());
+    forEach([&values](uint32_t v) { values.push_back(v); });
+    return values;
+}
@@ -0,0 +1,79 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Bitmap compressé à la manière de Roaring : les identifiants 32 bits sont
+// regroupés par leurs 16 bits de poids fort, et chaque groupe est stocké soit
+// en tableau trié (peu d'éléments), soit en bitset de 65536 bits (dense).
+class RoaringBitmap {
+private:
+    struct Container {
+        vector<uint16_t> array;  // utilisé quand le conteneur est creux
+        vector<uint64_t> bits;   // utilisé quand le conteneur est dense
+        uint32_t cardinality = 0;
+
+        bool isBitset() const { return !bits.empty(); }
+        bool contains(uint16_t low) const;
+        void add(uint16_t low);
+        void remove(uint16_t low);
+        void toBitset();
+        void toArray();
+    };
+
+    vector<uint16_t> keys;         // 16 bits de poids fort, triés
+    vector<Container> containers;  // un conteneur par clé
+
+    static Container intersect(const Container& a, const Container& b);
+    static Container unite(const Container& a, const Container& b);
+    size_t findKey(uint16_t key) const;
+
+public:
+    // Au-delà de ce nombre d'éléments, un conteneur passe en bitset
+    static const uint32_t ARRAY_LIMIT = 4096;
+
+    void add(uint32_t value);
+    void remove(uint32_t value);
+    bool contains(uint32_t value) const;
+    void clear();
+
+    size_t cardinality() const;
+    bool empty() const;
+
+    // Octets alloués hors de l'objet (clés et conteneurs)
+    size_t heapBytes() const;
+
+    // Tous les identifiants de 0 à count - 1
+    static RoaringBitmap range(uint32_t count);
+
+    friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b);
+    friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    // Parcourt les identifiants en ordre croissant
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uint32_t high = static_cast<uint32_t>(keys[i]) << 16;
+            const Container& c = containers[i];
+            if (c.isBitset()) {
+                for (size_t w = 0; w < c.bits.size(); ++w) {
+                    uint64_t word = c.bits[w];
+                    while (word) {
+                        int bit = __builtin_ctzll(word);
+                        fn(high | static_cast<uint32_t>(w * 64 + bit));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (uint16_t low : c.array) fn(high | low);
+            }
+        }
+    }
+
+    vector<uint32_t> toVector() const;
+};
+
+#endif
@@ -1,13 +1,20 @@
 #include "book.h"
+#include "collation.h"
+#include "memoryusage.h"
 #include <sstream>
 #include <iostream>
+#include <cstdlib>
 using namespace std;
 
 //  constructeurs
-Book::Book() : title(""), author(""), isbn(""), isAvailable(true), borrowerName("") {}
+Book::Book() : title(""), author(""), isbn(""), isAvailable(true), borrowerName(""),
+               borrowerId(""), checkoutDate(0), dueDate(0), loanSequence(0),
+               titleKey(frenchCollationKey("")), authorKey(frenchCollationKey("")) {}
 
 Book::Book(const string& title, const string& author, const string& isbn)
-    : title(title), author(author), isbn(isbn), isAvailable(true), borrowerName("") {}
+    : title(title), author(author), isbn(isbn), isAvailable(true), borrowerName(""),
+      borrowerId(""), checkoutDate(0), dueDate(0), loanSequence(0),
+      titleKey(frenchCollationKey(title)), authorKey(frenchCollationKey(author)) {}
 
 //  getters
 string Book::getTitle() const { return title; }
@@ -15,13 +22,41 @@ string Book::getAuthor() const { return author; }
 string Book::getISBN() const { return isbn; }
 bool Book::getAvailability() const { return isAvailable; }
 string Book::getBorrowerName() const { return borrowerName; }
+string Book::getBorrowerId() const { return borrowerId; }
+time_t Book::getCheckoutDate() const { return checkoutDate; }
+time_t Book::getDueDate() const { return dueDate; }
+uint64_t Book::getLoanSequence() const { return loanSequence; }
+const string& Book::getTitleKey() const { return titleKey; }
+const string& Book::getAuthorKey() const { return authorKey; }
+
+// date de retour au format AAAA-MM-JJ (vide si inconnue)
+string Book::getDueDateString() const {
+    if (dueDate == 0) return "";
+    char buffer[16];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d", localtime(&dueDate));
+    return buffer;
+}
+
+bool Book::isOverdue(time_t now) const {
+    return !isAvailable && dueDate != 0 && dueDate < now;
+}
 
 // setters
-void Book::setTitle(const string& title) { this->title = title; }
-void Book::setAuthor(const string& author) { this->author = author; }
+void Book::setTitle(const string& title) {
+    this->title = title;
+    titleKey = frenchCollationKey(title);
+}
+void Book::setAuthor(const string& author) {
+    this->author = author;
+    authorKey = frenchCollationKey(author);
+}
 void Book::setISBN(const string& isbn) { this->isbn = isbn; }
 void Book::setAvailability(bool available) { this->isAvailable = available; }
 void Book::setBorrowerName(const string& name) { this->borrowerName = name; }
+void Book::setBorrowerId(const string& id) { this->borrowerId = id; }
+void Book::setCheckoutDate(time_t date) { this->checkoutDate = date; }
+void Book::setDueDate(time_t date) { this->dueDate = date; }
+void Book::setLoanSequence(uint64_t sequence) { this->loanSequence = sequence; }
 
 // emprunt d’un livre
 void Book::checkOut(const string& borrower) {
@@ -31,15 +66,32 @@ void Book::checkOut(const string& borrower) {
     }
 }
 
+// emprunt avec l'identifiant de l'emprunteur et les dates du prêt
+void Book::checkOut(const string& borrower, const string& borrowerId, time_t checkoutDate, time_t dueDate) {
+    if (isAvailable) {
+        isAvailable = false;
+        borrowerName = borrower;
+        this->borrowerId = borrowerId;
+        this->checkoutDate = checkoutDate;
+        this->dueDate = dueDate;
+    }
+}
+
 // retouner un livre
 void Book::returnBook() {
     isAvailable = true;
     borrowerName = "";
+    borrowerId = "";
+    checkoutDate = 0;
+    dueDate = 0;
 }
 
 // afficher un livre
 string Book::toString() const {
     string etat = isAvailable ? "Disponible" : "Emprunté par " + borrowerName;
+    if (!isAvailable && dueDate != 0) {
+        etat += " (retour prévu le " + getDueDateString() + ")";
+    }
     return "Titre: " + title + "\nAuteur: " + author +
            "\nISBN: " + isbn + "\nStatut: " + etat;
 }
@@ -47,18 +99,38 @@ string Book::toString() const {
 //  fichier texte
 string Book::toFileFormat() const {
     return title + "|" + author + "|" + isbn + "|" +
-           (isAvailable ? "1" : "0") + "|" + borrowerName;
+           (isAvailable ? "1" : "0") + "|" + borrowerName + "|" + borrowerId + "|" +
+           to_string(static_cast<long long>(checkoutDate)) + "|" +
+           to_string(static_cast<long long>(dueDate));
 }
 
 
 // lire a partir du fichier texte
+// (les anciens fichiers n'ont pas les champs id / dates : ils restent vides)
 void Book::fromFileFormat(const string& line) {
     stringstream ss(line);
-    string dispo;
+    string dispo, checkout, due;
     getline(ss, title, '|');
     getline(ss, author, '|');
     getline(ss, isbn, '|');
     getline(ss, dispo, '|');
+    borrowerName = borrowerId = "";
     getline(ss, borrowerName, '|');
+    getline(ss, borrowerId, '|');
+    getline(ss, checkout, '|');
+    getline(ss, due, '|');
     isAvailable = (dispo == "1");
+    checkoutDate = static_cast<time_t>(atoll(checkout.c_str()));
+    dueDate = static_cast<time_t>(atoll(due.c_str()));
+    titleKey = frenchCollationKey(title);
+    authorKey = frenchCollationKey(author);
+}
+
+// Memory accounting
+size_t Book::heapBytes() const {
+    return stringHeapBytes(title) + stringHeapBytes(author) + stringHeapBytes(isbn) +
+           stringHeapBytes(borrowerName) + stringHeapBytes(borrowerId) +
+           stringHeapBytes(titleKey) + stringHeapBytes(authorKey);
 }
+
+size_t Book::memoryUsage() const { return sizeof(Book) + heapBytes(); }
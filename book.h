@@ -2,6 +2,8 @@
 #define BOOK_H
 
 #include <string>
+#include <ctime>
+#include <cstdint>
 
 using namespace std;
 
@@ -12,6 +14,12 @@ private:
     string isbn;
     bool isAvailable;
     string borrowerName;
+    string borrowerId;
+    time_t checkoutDate;  // 0 si inconnu
+    time_t dueDate;       // 0 si inconnu
+    uint64_t loanSequence; // numéro du prêt en cours, donné par la bibliothèque (non sauvegardé)
+    string titleKey;      // clés de tri (voir collation.h)
+    string authorKey;
 
 public:
     // Constructors
@@ -24,6 +32,14 @@ public:
     string getISBN() const;
     bool getAvailability() const;
     string getBorrowerName() const;
+    string getBorrowerId() const;
+    time_t getCheckoutDate() const;
+    time_t getDueDate() const;
+    uint64_t getLoanSequence() const;
+    string getDueDateString() const;
+    bool isOverdue(time_t now) const;
+    const string& getTitleKey() const;
+    const string& getAuthorKey() const;
     
     // Setters
     void setTitle(const string& title);
@@ -31,13 +47,22 @@ public:
     void setISBN(const string& isbn);
     void setAvailability(bool available);
     void setBorrowerName(const string& name);
+    void setBorrowerId(const string& id);
+    void setCheckoutDate(time_t date);
+    void setDueDate(time_t date);
+    void setLoanSequence(uint64_t sequence);
     
     // Methods
     void checkOut(const string& borrower);
+    void checkOut(const string& borrower, const string& borrowerId, time_t checkoutDate, time_t dueDate);
     void returnBook();
     string toString() const;
     string toFileFormat() const;
     void fromFileFormat(const string& line);
+    
+    // Memory accounting
+    size_t heapBytes() const;    // texte rangé hors de l'objet
+    size_t memoryUsage() const;  // objet + texte
 };
 
 #endif
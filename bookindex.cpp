@@ -0,0 +1,165 @@
+#include <algorithm>
+
+#include "bookindex.h"
+#include "memoryusage.h"
+
+using namespace std;
+
+static string toLowerCopy(string s) {
+    transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+static uint32_t trigramAt(const string& s, size_t i) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(s[i])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(s[i + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[i + 2]));
+}
+
+// ---- BookQuery ----
+
+BookQuery BookQuery::titleContains(const string& title) { return BookQuery(Type::TITLE, title); }
+BookQuery BookQuery::authorContains(const string& author) { return BookQuery(Type::AUTHOR, author); }
+BookQuery BookQuery::availableOnly() { return BookQuery(Type::AVAILABLE); }
+
+BookQuery operator&(const BookQuery& a, const BookQuery& b) {
+    BookQuery q(BookQuery::Type::AND);
+    q.children = {a, b};
+    return q;
+}
+
+BookQuery operator|(const BookQuery& a, const BookQuery& b) {
+    BookQuery q(BookQuery::Type::OR);
+    q.children = {a, b};
+    return q;
+}
+
+// ---- BookIndex ----
+
+void BookIndex::clear() {
+    bookCount = 0;
+    available.clear();
+    authorPostings.clear();
+    titleTrigrams.clear();
+}
+
+size_t BookIndex::heapBytes() const {
+    size_t bytes = available.heapBytes() + hashTableHeapBytes(authorPostings) + hashTableHeapBytes(titleTrigrams);
+    for (const auto& posting : authorPostings) bytes += stringHeapBytes(posting.first) + posting.second.heapBytes();
+    for (const auto& posting : titleTrigrams) bytes += posting.second.heapBytes();
+    return bytes;
+}
+
+void BookIndex::rebuild(const CowVector<Book>& books) {
+    clear();
+    for (size_t i = 0; i < books.size(); ++i) {
+        addBook(static_cast<uint32_t>(i), *books[i]);
+    }
+}
+
+void BookIndex::addBook(uint32_t id, const Book& book) {
+    bookCount = max(bookCount, id + 1);
+    if (book.getAvailability()) available.add(id);
+
+    authorPostings[toLowerCopy(book.getAuthor())].add(id);
+
+    string title = toLowerCopy(book.getTitle());
+    for (size_t i = 0; i + 3 <= title.size(); ++i) {
+        titleTrigrams[trigramAt(title, i)].add(id);
+    }
+}
+
+// Inverse of addBook; empty postings are dropped
+void BookIndex::removeBook(uint32_t id, const Book& book) {
+    if (id + 1 == bookCount) bookCount = id;
+    available.remove(id);
+
+    auto author = authorPostings.find(toLowerCopy(book.getAuthor()));
+    if (author != authorPostings.end()) {
+        author->second.remove(id);
+        if (author->second.empty()) authorPostings.erase(author);
+    }
+
+    string title = toLowerCopy(book.getTitle());
+    for (size_t i = 0; i + 3 <= title.size(); ++i) {
+        auto trigram = titleTrigrams.find(trigramAt(title, i));
+        if (trigram == titleTrigrams.end()) continue;
+        trigram->second.remove(id);
+        if (trigram->second.empty()) titleTrigrams.erase(trigram);
+    }
+}
+
+void BookIndex::setAvailability(uint32_t id, bool isAvailable) {
+    if (isAvailable) {
+        available.add(id);
+    } else {
+        available.remove(id);
+    }
+}
+
+// Titre : intersection des trigrammes de la requête, puis vérification des
+// seuls candidats (un trigramme commun ne garantit pas la sous-chaîne)
+RoaringBitmap BookIndex::evaluateTitle(const string& text, const CowVector<Book>& books) const {
+    string needle = toLowerCopy(text);
+    RoaringBitmap candidates;
+
+    if (needle.size() < 3) {
+        candidates = RoaringBitmap::range(bookCount);
+    } else {
+        for (size_t i = 0; i + 3 <= needle.size(); ++i) {
+            auto it = titleTrigrams.find(trigramAt(needle, i));
+            if (it == titleTrigrams.end()) return RoaringBitmap();
+            candidates = (i == 0) ? it->second : (candidates & it->second);
+            if (candidates.empty()) return candidates;
+        }
+    }
+
+    RoaringBitmap result;
+    candidates.forEach([&](uint32_t id) {
+        if (toLowerCopy(books[id]->getTitle()).find(needle) != string::npos) {
+            result.add(id);
+        }
+    });
+    return result;
+}
+
+// Auteur : union des listes de chaque auteur distinct qui contient le texte
+RoaringBitmap BookIndex::evaluateAuthor(const string& text) const {
+    string needle = toLowerCopy(text);
+    RoaringBitmap result;
+    for (const auto& entry : authorPostings) {
+        if (entry.first.find(needle) != string::npos) {
+            result = result | entry.second;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap BookIndex::evaluate(const BookQuery& query, const CowVector<Book>& books) const {
+    switch (query.getType()) {
+        case BookQuery::Type::TITLE:
+            return evaluateTitle(query.getText(), books);
+        case BookQuery::Type::AUTHOR:
+            return evaluateAuthor(query.getText());
+        case BookQuery::Type::AVAILABLE:
+            return available;
+        case BookQuery::Type::AND: {
+            RoaringBitmap result;
+            bool first = true;
+            for (const BookQuery& child : query.getChildren()) {
+                result = first ? evaluate(child, books) : (result & evaluate(child, books));
+                first = false;
+                if (result.empty()) break;
+            }
+            return result;
+        }
+        case BookQuery::Type::OR: {
+            RoaringBitmap result;
+            for (const BookQuery& child : query.getChildren()) {
+                result = result | evaluate(child, books);
+            }
+            return result;
+        }
+    }
+    return RoaringBitmap();
+}
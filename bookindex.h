@@ -0,0 +1,70 @@
+#ifndef BOOKINDEX_H
+#define BOOKINDEX_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "bitmap.h"
+#include "book.h"
+#include "cowvector.h"
+
+using namespace std;
+
+// Requête combinable sur le catalogue : prédicats titre / auteur / disponibilité
+// reliés par ET / OU.
+class BookQuery {
+public:
+    enum class Type { TITLE, AUTHOR, AVAILABLE, AND, OR };
+
+private:
+    Type type;
+    string text;                  // texte recherché (TITLE, AUTHOR)
+    vector<BookQuery> children;   // sous-requêtes (AND, OR)
+
+    BookQuery(Type type, const string& text = "") : type(type), text(text) {}
+
+public:
+    static BookQuery titleContains(const string& title);
+    static BookQuery authorContains(const string& author);
+    static BookQuery availableOnly();
+
+    Type getType() const { return type; }
+    const string& getText() const { return text; }
+    const vector<BookQuery>& getChildren() const { return children; }
+
+    friend BookQuery operator&(const BookQuery& a, const BookQuery& b);
+    friend BookQuery operator|(const BookQuery& a, const BookQuery& b);
+};
+
+// Index en bitmaps sur les livres de la bibliothèque. Les identifiants sont les
+// positions des livres dans Library::books.
+//  - un bitmap des livres disponibles
+//  - une liste (posting) par auteur
+//  - une liste par trigramme de titre, pour les recherches de sous-chaînes
+class BookIndex {
+private:
+    uint32_t bookCount = 0;
+    RoaringBitmap available;
+    unordered_map<string, RoaringBitmap> authorPostings;  // auteur en minuscules
+    unordered_map<uint32_t, RoaringBitmap> titleTrigrams; // 3 octets en minuscules
+
+    RoaringBitmap evaluateTitle(const string& text, const CowVector<Book>& books) const;
+    RoaringBitmap evaluateAuthor(const string& text) const;
+
+public:
+    void clear();
+    void rebuild(const CowVector<Book>& books);
+    void addBook(uint32_t id, const Book& book);
+    void removeBook(uint32_t id, const Book& book);
+    void setAvailability(uint32_t id, bool isAvailable);
+
+    // Octets alloués hors de l'objet (tables et bitmaps)
+    size_t heapBytes() const;
+
+    // Évalue la requête et retourne les identifiants correspondants
+    RoaringBitmap evaluate(const BookQuery& query, const CowVector<Book>& books) const;
+};
+
+#endif
@@ -0,0 +1,585 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <unordered_set>
+
+#include "catalogexchange.h"
+#include "threadpool.h"
+
+using namespace std;
+
+static const char* const BOOK_COLUMNS[] = {"title", "author", "isbn", "available", "borrower_id",
+                                           "borrower_name", "checkout_date", "due_date"};
+static const char* const USER_COLUMNS[] = {"name", "id", "borrowed"};
+static const char* const LOAN_COLUMNS[] = {"isbn", "title", "user_id", "borrower_name", "checkout_date", "due_date"};
+
+bool CatalogExchange::formatFromPath(const string& path, Format& format) {
+    size_t dot = path.rfind('.');
+    string extension = (dot == string::npos) ? "" : path.substr(dot + 1);
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == "csv") {
+        format = Format::CSV;
+    } else if (extension == "jsonl" || extension == "json") {
+        format = Format::JSONL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool CatalogExchange::validateIsbn(const string& isbn, string& normalized) {
+    normalized.clear();
+    for (char c : isbn) {
+        if (c != '-' && c != ' ') normalized += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+
+    if (normalized.size() == 10) {
+        int sum = 0;
+        for (size_t i = 0; i < 10; ++i) {
+            char c = normalized[i];
+            int digit;
+            if (isdigit(static_cast<unsigned char>(c))) {
+                digit = c - '0';
+            } else if (c == 'X' && i == 9) {
+                digit = 10;
+            } else {
+                return false;
+            }
+            sum += static_cast<int>(10 - i) * digit;
+        }
+        if (sum % 11 != 0) return false;
+
+        // converti en ISBN-13 (préfixe 978, nouvelle clé), comme à la saisie du menu
+        normalized = "978" + normalized.substr(0, 9);
+        sum = 0;
+        for (size_t i = 0; i < 12; ++i) sum += (normalized[i] - '0') * (i % 2 == 0 ? 1 : 3);
+        normalized += static_cast<char>('0' + (10 - sum % 10) % 10);
+        return true;
+    }
+
+    if (normalized.size() == 13) {
+        int sum = 0;
+        for (size_t i = 0; i < 13; ++i) {
+            if (!isdigit(static_cast<unsigned char>(normalized[i]))) return false;
+            sum += (normalized[i] - '0') * (i % 2 == 0 ? 1 : 3);
+        }
+        return sum % 10 == 0;
+    }
+    return false;
+}
+
+// ---- Export ----
+
+void CatalogExchange::writeCsvField(ostream& out, const string& value) {
+    if (value.find_first_of(",\"\r\n") == string::npos) {
+        out << value;
+        return;
+    }
+    out << '"';
+    for (char c : value) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+void CatalogExchange::writeJsonString(ostream& out, const string& value) {
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char hex[] = "0123456789abcdef";
+                    out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                } else {
+                    out << c; // UTF-8 gardé tel quel
+                }
+        }
+    }
+    out << '"';
+}
+
+string CatalogExchange::isoDate(time_t date) {
+    if (date == 0) return "";
+    char text[32];
+    strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", gmtime(&date));
+    return text;
+}
+
+size_t CatalogExchange::exportTo(const LibrarySnapshot& snapshot, Kind kind, Format format, ostream& out) {
+    const char* const* columns;
+    size_t columnCount;
+    if (kind == Kind::BOOKS) {
+        columns = BOOK_COLUMNS;
+        columnCount = size(BOOK_COLUMNS);
+    } else if (kind == Kind::USERS) {
+        columns = USER_COLUMNS;
+        columnCount = size(USER_COLUMNS);
+    } else {
+        columns = LOAN_COLUMNS;
+        columnCount = size(LOAN_COLUMNS);
+    }
+
+    if (format == Format::CSV) {
+        for (size_t i = 0; i < columnCount; ++i) out << (i ? "," : "") << columns[i];
+        out << "\n";
+    }
+
+    // une ligne à la fois : seules les valeurs de la fiche en cours sont gardées
+    vector<string> values;
+    vector<string> list; // ISBN empruntés (tableau en JSON)
+    size_t rows = 0;
+    auto writeRow = [&]() {
+        if (format == Format::CSV) {
+            for (size_t i = 0; i < columnCount; ++i) {
+                if (i) out << ',';
+                writeCsvField(out, values[i]);
+            }
+        } else {
+            out << '{';
+            for (size_t i = 0; i < columnCount; ++i) {
+                if (i) out << ',';
+                out << '"' << columns[i] << "\":";
+                if (kind == Kind::BOOKS && i == 3) {
+                    out << values[i]; // available : booléen
+                } else if (kind == Kind::USERS && i == 2) {
+                    out << '[';
+                    for (size_t k = 0; k < list.size(); ++k) {
+                        if (k) out << ',';
+                        writeJsonString(out, list[k]);
+                    }
+                    out << ']';
+                } else {
+                    writeJsonString(out, values[i]);
+                }
+            }
+            out << '}';
+        }
+        out << '\n';
+        rows++;
+    };
+
+    if (kind == Kind::USERS) {
+        for (size_t i = 0; i < snapshot.getUserCount(); ++i) {
+            const User& user = snapshot.getUser(i);
+            list = user.getBorrowedBooks();
+            string joined;
+            for (size_t k = 0; k < list.size(); ++k) joined += (k ? ";" : "") + list[k];
+            values = {user.getName(), user.getUserId(), joined};
+            writeRow();
+        }
+        return rows;
+    }
+
+    for (size_t i = 0; i < snapshot.getBookCount(); ++i) {
+        const Book& book = snapshot.getBook(i);
+        if (kind == Kind::BOOKS) {
+            values = {book.getTitle(), book.getAuthor(), book.getISBN(),
+                      book.getAvailability() ? "true" : "false", book.getBorrowerId(), book.getBorrowerName(),
+                      isoDate(book.getCheckoutDate()), isoDate(book.getDueDate())};
+        } else if (!book.getAvailability()) {
+            values = {book.getISBN(), book.getTitle(), book.getBorrowerId(), book.getBorrowerName(),
+                      isoDate(book.getCheckoutDate()), isoDate(book.getDueDate())};
+        } else {
+            continue;
+        }
+        writeRow();
+    }
+    return rows;
+}
+
+// ---- Import ----
+
+CatalogExchange::RecordReader::RecordReader(istream& in, Format format) : in(in), format(format) {
+    char bom[3];
+    in.read(bom, 3);
+    if (in.gcount() != 3 || memcmp(bom, "\xEF\xBB\xBF", 3) != 0) buffer.assign(bom, in.gcount()); // BOM UTF-8
+}
+
+// Cut the next records (one per line; a quoted CSV field may span lines)
+bool CatalogExchange::RecordReader::next(size_t maxRecords, vector<RecordSpan>& spans) {
+    spans.clear();
+    buffer.erase(0, recordStart); // fenêtre précédente terminée
+    scan -= recordStart;
+    recordStart = 0;
+
+    while (spans.size() < maxRecords) {
+        const void* newline = memchr(buffer.data() + scan, '\n', buffer.size() - scan);
+        if (!newline) {
+            if (format == Format::CSV) quotes += count(buffer.begin() + scan, buffer.end(), '"');
+            scan = buffer.size();
+            if (atEnd) {
+                if (recordStart < buffer.size()) {
+                    size_t length = buffer.size() - recordStart;
+                    if (buffer[recordStart + length - 1] == '\r') length--;
+                    if (length > 0) spans.push_back({recordStart, length, recordLine});
+                }
+                recordStart = buffer.size();
+                break;
+            }
+            size_t size = buffer.size();
+            buffer.resize(size + READ_BLOCK);
+            in.read(&buffer[size], READ_BLOCK);
+            buffer.resize(size + static_cast<size_t>(in.gcount()));
+            if (buffer.size() == size) atEnd = true;
+            continue;
+        }
+
+        size_t end = static_cast<size_t>(static_cast<const char*>(newline) - buffer.data());
+        if (format == Format::CSV) quotes += count(buffer.begin() + scan, buffer.begin() + end, '"');
+        scan = end + 1;
+        line++;
+        if (quotes % 2 != 0) continue; // guillemets ouverts : la fiche continue à la ligne suivante
+
+        size_t length = end - recordStart;
+        if (length > 0 && buffer[end - 1] == '\r') length--;
+        if (length > 0) spans.push_back({recordStart, length, recordLine});
+        recordStart = scan;
+        recordLine = line;
+        quotes = 0;
+    }
+    return !spans.empty();
+}
+
+bool CatalogExchange::parseCsvRecord(const string& data, const RecordSpan& span, vector<string>& fields) {
+    fields.clear();
+    fields.emplace_back();
+    const char* p = data.data() + span.offset;
+    const char* end = p + span.length;
+    bool quoted = false;
+
+    while (p < end) {
+        char c = *p++;
+        if (quoted) {
+            if (c != '"') {
+                fields.back() += c;
+            } else if (p < end && *p == '"') {
+                fields.back() += '"'; // "" : guillemet littéral
+                p++;
+            } else {
+                quoted = false;
+                if (p < end && *p != ',') return false; // texte après le guillemet fermant
+            }
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c == '"') {
+            if (!fields.back().empty()) return false; // guillemet au milieu d'un champ non protégé
+            quoted = true;
+        } else {
+            fields.back() += c;
+        }
+    }
+    return !quoted;
+}
+
+static void skipSpaces(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+}
+
+static void appendUtf8(string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+static bool readHex4(const char*& p, const char* end, uint32_t& value) {
+    if (end - p < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = *p++;
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+// JSON string starting at the opening quote
+static bool readJsonString(const char*& p, const char* end, string& out) {
+    out.clear();
+    if (p >= end || *p != '"') return false;
+    p++;
+    while (p < end) {
+        char c = *p++;
+        if (c == '"') return true;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (p >= end) return false;
+        char escape = *p++;
+        switch (escape) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!readHex4(p, end, code)) return false;
+                // paire de substitution UTF-16
+                if (code >= 0xD800 && code < 0xDC00) {
+                    uint32_t low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u') return false;
+                    p += 2;
+                    if (!readHex4(p, end, low) || low < 0xDC00 || low >= 0xE000) return false;
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+// Any JSON value; strings are decoded, arrays of strings joined with ';',
+// other values kept as written (true, 12, null -> "")
+static bool readJsonValue(const char*& p, const char* end, string& out) {
+    if (p >= end) return false;
+    if (*p == '"') return readJsonString(p, end, out);
+    if (*p == '{') return false; // objets imbriqués non acceptés
+
+    out.clear();
+    if (*p == '[') {
+        p++;
+        skipSpaces(p, end);
+        if (p < end && *p == ']') {
+            p++;
+            return true;
+        }
+        string item;
+        for (;;) {
+            skipSpaces(p, end);
+            if (!readJsonValue(p, end, item)) return false;
+            if (!out.empty()) out += ';';
+            out += item;
+            skipSpaces(p, end);
+            if (p < end && *p == ',') {
+                p++;
+            } else if (p < end && *p == ']') {
+                p++;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t') p++;
+    out.assign(start, p);
+    if (out.empty()) return false;
+    if (out == "null") out.clear();
+    return true;
+}
+
+bool CatalogExchange::parseJsonRecord(const string& data, const RecordSpan& span,
+                                      vector<pair<string, string>>& fields) {
+    fields.clear();
+    const char* p = data.data() + span.offset;
+    const char* end = p + span.length;
+
+    skipSpaces(p, end);
+    if (p >= end || *p++ != '{') return false;
+    skipSpaces(p, end);
+    if (p < end && *p == '}') return true;
+
+    string key, value;
+    for (;;) {
+        skipSpaces(p, end);
+        if (!readJsonString(p, end, key)) return false;
+        skipSpaces(p, end);
+        if (p >= end || *p++ != ':') return false;
+        skipSpaces(p, end);
+        if (!readJsonValue(p, end, value)) return false;
+        fields.emplace_back(key, value);
+        skipSpaces(p, end);
+        if (p < end && *p == ',') {
+            p++;
+        } else if (p < end && *p == '}') {
+            p++;
+            skipSpaces(p, end);
+            return p == end;
+        } else {
+            return false;
+        }
+    }
+}
+
+void CatalogExchange::parseRow(const string& data, const RecordSpan& span, Kind kind, Format format,
+                               const vector<string>& header, ParsedRow& row) {
+    vector<string> csvFields;
+    vector<pair<string, string>> jsonFields;
+    if (format == Format::CSV ? !parseCsvRecord(data, span, csvFields) : !parseJsonRecord(data, span, jsonFields)) {
+        row.error = (format == Format::CSV) ? "ligne CSV mal formée" : "objet JSON mal formé";
+        return;
+    }
+
+    // valeur d'une colonne ; false si la colonne est absente
+    auto field = [&](const char* name, string& value) {
+        if (format == Format::CSV) {
+            auto column = find(header.begin(), header.end(), name);
+            if (column == header.end() || static_cast<size_t>(column - header.begin()) >= csvFields.size()) {
+                return false;
+            }
+            value = csvFields[column - header.begin()];
+            return true;
+        }
+        for (const auto& entry : jsonFields) {
+            if (entry.first == name) {
+                value = entry.second;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // séparateurs du format texte (books.txt / users.txt) : refusés dans les valeurs
+    auto storable = [](const string& value) { return value.find_first_of("|\r\n") == string::npos; };
+
+    if (kind == Kind::BOOKS) {
+        string title, author, isbn;
+        if (!field("title", title) || title.empty()) {
+            row.error = "titre manquant";
+        } else if (!field("author", author) || author.empty()) {
+            row.error = "auteur manquant";
+        } else if (!storable(title) || !storable(author)) {
+            row.error = "caractère interdit (| ou saut de ligne)";
+        } else if (!field("isbn", isbn) || isbn.empty()) {
+            row.error = "ISBN manquant";
+        } else if (!validateIsbn(isbn, row.key)) {
+            row.error = "ISBN invalide : " + isbn;
+        } else {
+            row.book = Book(title, author, row.key); // clés de tri calculées ici, en parallèle
+        }
+        return;
+    }
+
+    string name;
+    if (!field("name", name) || name.empty()) {
+        row.error = "nom manquant";
+    } else if (!field("id", row.key) || row.key.empty()) {
+        row.error = "ID manquant";
+    } else if (!storable(name) || !storable(row.key)) {
+        row.error = "caractère interdit (| ou saut de ligne)";
+    } else {
+        row.user = User(name, row.key);
+    }
+}
+
+CatalogExchange::ImportResult CatalogExchange::importFrom(Library& library, Kind kind, Format format,
+                                                          const string& path, ostream& errorReport) {
+    ImportResult result;
+    if (kind == Kind::LOANS) return result;
+
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return result;
+    result.opened = true;
+
+    errorReport << "ligne,erreur\n";
+    auto reject = [&](size_t line, const string& error) {
+        errorReport << line << ',';
+        writeCsvField(errorReport, error);
+        errorReport << '\n';
+        result.rejected++;
+    };
+
+    RecordReader reader(file, format);
+    const string& data = reader.data();
+    vector<RecordSpan> spans;
+    vector<string> header;
+    if (format == Format::CSV) {
+        if (!reader.next(1, spans)) return result;
+        if (!parseCsvRecord(data, spans[0], header)) {
+            reject(spans[0].line, "en-tête CSV mal formé");
+            return result;
+        }
+        for (string& name : header) {
+            name.erase(0, name.find_first_not_of(" \t"));
+            name.erase(name.find_last_not_of(" \t") + 1);
+            transform(name.begin(), name.end(), name.begin(), ::tolower);
+        }
+    }
+
+    // Par fenêtres de INSERT_BATCH lignes : analyse en parallèle (paquets de
+    // PARSE_CHUNK_ROWS lignes), puis doublons et ajout du lot dans l'ordre du
+    // fichier. Seules les fiches de la fenêtre en cours sont gardées : une clé
+    // déjà vue dans une fenêtre précédente est dans la bibliothèque, et elle
+    // est refusée comme « déjà dans le catalogue ».
+    unordered_set<string> seen;
+    vector<ParsedRow> rows;
+    vector<Book> bookBatch;
+    vector<User> userBatch;
+
+    while (reader.next(INSERT_BATCH, spans)) {
+        result.rows += spans.size();
+        rows.assign(spans.size(), ParsedRow());
+        seen.clear();
+
+        vector<function<void()>> tasks;
+        for (size_t begin = 0; begin < rows.size(); begin += PARSE_CHUNK_ROWS) {
+            size_t end = min(rows.size(), begin + PARSE_CHUNK_ROWS);
+            tasks.push_back([&, begin, end]() {
+                for (size_t i = begin; i < end; ++i) {
+                    parseRow(data, spans[i], kind, format, header, rows[i]);
+                }
+            });
+        }
+        ThreadPool::shared().runAll(tasks);
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            ParsedRow& row = rows[i];
+            size_t line = spans[i].line;
+            if (!row.error.empty()) {
+                reject(line, row.error);
+                continue;
+            }
+            auto inserted = seen.insert(move(row.key));
+            const string& key = *inserted.first;
+            if (!inserted.second) {
+                reject(line, "doublon dans le fichier : " + key);
+            } else if (kind == Kind::BOOKS ? library.findBookByISBN(key) != nullptr
+                                           : library.findUserById(key) != nullptr) {
+                reject(line, "déjà dans le catalogue : " + key);
+            } else if (kind == Kind::BOOKS) {
+                bookBatch.push_back(move(row.book));
+            } else {
+                userBatch.push_back(move(row.user));
+            }
+        }
+
+        result.imported += bookBatch.size() + userBatch.size();
+        library.addBooks(move(bookBatch));
+        library.addUsers(move(userBatch));
+        bookBatch.clear();
+        userBatch.clear();
+    }
+    return result;
+}
@@ -0,0 +1,110 @@
+#ifndef CATALOGEXCHANGE_H
+#define CATALOGEXCHANGE_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <istream>
+
+#include "library.h"
+
+using namespace std;
+
+// Échange du catalogue avec d'autres systèmes, en CSV (RFC 4180, avec une
+// ligne d'en-tête) ou en JSON Lines (un objet par ligne).
+//  - l'export écrit fiche par fiche depuis un instantané : la mémoire utilisée
+//    ne dépend pas de la taille du catalogue ;
+//  - l'import lit le fichier par fenêtres de INSERT_BATCH fiches, analysées
+//    en parallèle par paquets de lignes : seule la fenêtre en cours est en
+//    mémoire. Il valide les ISBN, écarte les doublons (dans le fichier et dans le
+//    catalogue) puis ajoute les fiches par lots. Chaque ligne refusée est
+//    notée dans un rapport d'erreurs.
+// Colonnes :
+//   livres       title, author, isbn, available, borrower_id, borrower_name, checkout_date, due_date
+//   utilisateurs name, id, borrowed (ISBN séparés par « ; », tableau en JSON)
+//   prêts        isbn, title, user_id, borrower_name, checkout_date, due_date
+// Les dates sont en ISO 8601 (UTC). L'import ne lit que les colonnes
+// d'identité (title/author/isbn, name/id) : les prêts restent gérés par la
+// bibliothèque qui les a enregistrés.
+class CatalogExchange {
+public:
+    enum class Kind { BOOKS, USERS, LOANS };
+    enum class Format { CSV, JSONL };
+
+    static const size_t PARSE_CHUNK_ROWS = 4096;  // lignes par tâche d'analyse
+    static const size_t INSERT_BATCH = 65536;     // fiches par ajout dans la bibliothèque
+    static const size_t READ_BLOCK = 1 << 20;     // octets lus à la fois
+
+    struct ImportResult {
+        bool opened = false;
+        size_t rows = 0;      // lignes de données lues (sans l'en-tête)
+        size_t imported = 0;
+        size_t rejected = 0;  // invalides ou doublons, détaillés dans le rapport
+    };
+
+    // Format d'après l'extension (.csv, sinon JSON Lines pour .jsonl / .json) ;
+    // false si l'extension n'est pas reconnue
+    static bool formatFromPath(const string& path, Format& format);
+
+    // Écrit les fiches de l'instantané ; retourne le nombre de lignes écrites
+    static size_t exportTo(const LibrarySnapshot& snapshot, Kind kind, Format format, ostream& out);
+
+    // Ajoute les livres ou utilisateurs du fichier (LOANS n'est pas importable).
+    // Les lignes refusées sont écrites dans errorReport ("ligne,erreur" en CSV).
+    static ImportResult importFrom(Library& library, Kind kind, Format format, const string& path,
+                                   ostream& errorReport);
+
+    // ISBN-10 ou ISBN-13 avec une clé de contrôle correcte ; normalized reçoit
+    // l'ISBN-13 sans tirets ni espaces (un ISBN-10 est converti)
+    static bool validateIsbn(const string& isbn, string& normalized);
+
+private:
+    // Une fiche du fichier d'entrée : position dans les données et numéro de ligne
+    struct RecordSpan {
+        size_t offset;
+        size_t length;
+        size_t line;
+    };
+
+    // Résultat de l'analyse d'une fiche (fait en parallèle)
+    struct ParsedRow {
+        string key;    // ISBN normalisé ou ID utilisateur
+        Book book;
+        User user;
+        string error;  // vide si la fiche est valide
+    };
+
+    // Lecture du fichier par blocs de READ_BLOCK octets : découpe les fiches
+    // complètes (une par ligne ; un champ CSV entre guillemets peut couvrir
+    // plusieurs lignes) et garde la fiche incomplète pour le bloc suivant
+    class RecordReader {
+    public:
+        RecordReader(istream& in, Format format);
+        // Au plus maxRecords fiches dans spans, qui pointent dans data() jusqu'à
+        // l'appel suivant ; false à la fin du fichier
+        bool next(size_t maxRecords, vector<RecordSpan>& spans);
+        const string& data() const { return buffer; }
+
+    private:
+        istream& in;
+        Format format;
+        string buffer;
+        size_t recordStart = 0;  // début de la fiche en cours dans buffer
+        size_t scan = 0;         // octets de la fiche en cours déjà parcourus
+        size_t quotes = 0;       // guillemets vus dans la fiche en cours
+        size_t line = 1;
+        size_t recordLine = 1;
+        bool atEnd = false;
+    };
+
+    static bool parseCsvRecord(const string& data, const RecordSpan& span, vector<string>& fields);
+    static bool parseJsonRecord(const string& data, const RecordSpan& span, vector<pair<string, string>>& fields);
+    static void parseRow(const string& data, const RecordSpan& span, Kind kind, Format format,
+                         const vector<string>& header, ParsedRow& row);
+
+    static void writeCsvField(ostream& out, const string& value);
+    static void writeJsonString(ostream& out, const string& value);
+    static string isoDate(time_t date);
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <algorithm>
+
+#include "collation.h"
+
+using namespace std;
+
+// Poids des accents (niveau 2)
+enum Accent : uint8_t { NONE = 0, ACUTE, GRAVE, CIRCUMFLEX, DIAERESIS, CEDILLA, TILDE, RING, STROKE, LIGATURE };
+
+struct Mapping {
+    const char* base;  // lettres de base (nullptr : caractère ignoré)
+    Accent accent;
+};
+
+// U+00C0 à U+00DF ; les minuscules U+00E0 à U+00FF ont les mêmes lettres de base
+static const Mapping LATIN1[32] = {
+    {"a", GRAVE}, {"a", ACUTE}, {"a", CIRCUMFLEX}, {"a", TILDE}, {"a", DIAERESIS}, {"a", RING},
+    {"ae", LIGATURE}, {"c", CEDILLA}, {"e", GRAVE}, {"e", ACUTE}, {"e", CIRCUMFLEX}, {"e", DIAERESIS},
+    {"i", GRAVE}, {"i", ACUTE}, {"i", CIRCUMFLEX}, {"i", DIAERESIS}, {"d", STROKE}, {"n", TILDE},
+    {"o", GRAVE}, {"o", ACUTE}, {"o", CIRCUMFLEX}, {"o", TILDE}, {"o", DIAERESIS}, {nullptr, NONE},
+    {"o", STROKE}, {"u", GRAVE}, {"u", ACUTE}, {"u", CIRCUMFLEX}, {"u", DIAERESIS}, {"y", ACUTE},
+    {"th", LIGATURE}, {"ss", LIGATURE},
+};
+
+// Séparateur entre les niveaux (plus petit que tout poids)
+static const char LEVEL_SEPARATOR = '\x01';
+
+// Decode one UTF-8 code point; invalid bytes are read as Latin-1
+static uint32_t nextCodePoint(const string& s, size_t& i) {
+    unsigned char c = s[i++];
+    int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+    if (c < 0x80 || extra == 0 || i + extra > s.size()) return c;
+
+    uint32_t cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        unsigned char next = s[i + k];
+        if ((next & 0xC0) != 0x80) return c;
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return cp;
+}
+
+string frenchCollationKey(const string& utf8) {
+    string primary, secondary, tertiary;
+    primary.reserve(utf8.size());
+
+    auto emit = [&](const char* base, Accent accent, bool upper) {
+        for (const char* p = base; *p; ++p) {
+            primary += static_cast<char>(0x20 + (*p - 'a'));
+            secondary += static_cast<char>(0x02 + accent);
+            tertiary += static_cast<char>(upper ? 0x03 : 0x02);
+        }
+    };
+
+    size_t i = 0;
+    while (i < utf8.size()) {
+        uint32_t cp = nextCodePoint(utf8, i);
+
+        if (cp >= 'a' && cp <= 'z') {
+            char base[2] = {static_cast<char>(cp), '\0'};
+            emit(base, NONE, false);
+        } else if (cp >= 'A' && cp <= 'Z') {
+            char base[2] = {static_cast<char>(cp - 'A' + 'a'), '\0'};
+            emit(base, NONE, true);
+        } else if (cp >= '0' && cp <= '9') {
+            primary += static_cast<char>(0x10 + (cp - '0'));
+            secondary += '\x02';
+            tertiary += '\x02';
+        } else if (cp == ' ' || cp == '\t' || cp == 0xA0) {
+            primary += '\x03';
+            secondary += '\x02';
+            tertiary += '\x02';
+        } else if (cp >= 0xC0 && cp <= 0xFF) {
+            const Mapping& m = LATIN1[(cp - 0xC0) & 0x1F];
+            bool upper = cp < 0xE0 && cp != 0xDF;
+            if (cp == 0xFF) {
+                emit("y", DIAERESIS, false);   // ÿ
+            } else if (m.base) {
+                emit(m.base, m.accent, upper);
+            }
+        } else if (cp == 0x152 || cp == 0x153) {
+            emit("oe", LIGATURE, cp == 0x152);  // Œ œ
+        } else if (cp == 0x178) {
+            emit("y", DIAERESIS, true);         // Ÿ
+        } else if (cp >= 0x100) {
+            // autres écritures : après les lettres latines, dans l'ordre des points de code
+            primary += '\x60';
+            primary += static_cast<char>(((cp >> 14) & 0x7F) + 1);
+            primary += static_cast<char>(((cp >> 7) & 0x7F) + 1);
+            primary += static_cast<char>((cp & 0x7F) + 1);
+            secondary += '\x02';
+            tertiary += '\x02';
+        }
+        // ponctuation et symboles ASCII : ignorés
+    }
+
+    // accents comparés depuis la fin (règle française)
+    reverse(secondary.begin(), secondary.end());
+    return primary + LEVEL_SEPARATOR + secondary + LEVEL_SEPARATOR + tertiary;
+}
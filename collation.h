@@ -0,0 +1,20 @@
+#ifndef COLLATION_H
+#define COLLATION_H
+
+#include <string>
+
+using namespace std;
+
+// Clé de tri binaire selon l'ordre français : comparer deux clés octet par
+// octet donne le même résultat que comparer les textes selon les règles
+// suivantes.
+//  1. lettres de base, sans accents ni casse (espace < chiffres < lettres ;
+//     la ponctuation est ignorée) ;
+//  2. accents (aucun < aigu < grave < circonflexe < tréma ...), comparés à
+//     partir de la fin du mot, comme en français canadien ;
+//  3. casse (minuscule < majuscule).
+// La clé ne contient jamais l'octet 0 : on peut concaténer des clés avec un
+// séparateur 0 pour trier sur plusieurs champs.
+string frenchCollationKey(const string& utf8);
+
+#endif
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <functional>
+
+#include "compactcatalog.h"
+#include "threadpool.h"
+#include "varint.h"
+
+using namespace std;
+
+static const char CATALOG_MAGIC[4] = {'B', 'C', 'T', '1'};
+
+// ---- ISBN : entier quand c'est possible ----
+// en-tête varint = (longueur << 2) | sorte
+//   sorte 0 : chiffres seulement, suivis de leur valeur en varint
+//   sorte 1 : chiffres terminés par X (ISBN-10), valeur des chiffres en varint
+//   sorte 2 : texte brut
+enum IsbnKind : uint64_t { ISBN_DIGITS = 0, ISBN_DIGITS_X = 1, ISBN_RAW = 2 };
+
+static void putIsbn(string& out, const string& isbn) {
+    IsbnKind kind = (!isbn.empty() && isbn.back() == 'X') ? ISBN_DIGITS_X : ISBN_DIGITS;
+    size_t digitCount = (kind == ISBN_DIGITS_X) ? isbn.size() - 1 : isbn.size();
+    bool numeric = digitCount > 0 && digitCount <= 19 &&
+                   all_of(isbn.begin(), isbn.begin() + digitCount, ::isdigit);
+    if (!numeric) {
+        putVarint(out, (static_cast<uint64_t>(isbn.size()) << 2) | ISBN_RAW);
+        out += isbn;
+        return;
+    }
+    putVarint(out, (static_cast<uint64_t>(isbn.size()) << 2) | kind);
+    putVarint(out, stoull(isbn.substr(0, digitCount)));
+}
+
+static bool getIsbn(const string& in, size_t& pos, string& isbn) {
+    uint64_t header;
+    if (!getVarint(in, pos, header)) return false;
+    size_t length = static_cast<size_t>(header >> 2);
+    uint64_t kind = header & 3;
+
+    if (kind == ISBN_RAW) {
+        if (length > in.size() - pos) return false;
+        isbn.assign(in, pos, length);
+        pos += length;
+        return true;
+    }
+
+    uint64_t value;
+    if (!getVarint(in, pos, value) || length == 0 || length > 20) return false;
+    size_t digitCount = (kind == ISBN_DIGITS_X) ? length - 1 : length;
+    string digits = to_string(value);
+    if (digits.size() > digitCount) return false;
+    isbn.assign(digitCount - digits.size(), '0'); // zéros de tête
+    isbn += digits;
+    if (kind == ISBN_DIGITS_X) isbn += 'X';
+    return true;
+}
+
+// ---- Encodage ----
+
+string CompactCatalog::encodeBookBlock(const vector<const Book*>& books, size_t begin, size_t end,
+                                       const unordered_map<string, uint64_t>& authorIds,
+                                       const unordered_map<string, uint64_t>& userIndex) {
+    string out;
+    string previous; // le front coding repart de zéro à chaque bloc
+    for (size_t i = begin; i < end; ++i) {
+        const Book& book = *books[i];
+        string title = book.getTitle();
+        size_t shared = 0;
+        size_t limit = min(previous.size(), title.size());
+        while (shared < limit && previous[shared] == title[shared]) shared++;
+        putVarint(out, shared);
+        putString(out, title.substr(shared));
+        previous = move(title);
+
+        putVarint(out, authorIds.at(book.getAuthor()));
+        putIsbn(out, book.getISBN());
+
+        if (book.getAvailability()) {
+            putVarint(out, 0);
+            continue;
+        }
+        // prêt : référence vers l'utilisateur si on le connaît
+        auto user = userIndex.find(book.getBorrowerId());
+        if (user != userIndex.end()) {
+            putVarint(out, user->second + 2);
+        } else {
+            putVarint(out, 1);
+            putString(out, book.getBorrowerName());
+            putString(out, book.getBorrowerId());
+        }
+        putVarint(out, zigzag(book.getCheckoutDate()));
+        putVarint(out, zigzag(book.getDueDate() - book.getCheckoutDate()));
+    }
+    return out;
+}
+
+string CompactCatalog::encodeUserBlock(const vector<const User*>& users, size_t begin, size_t end,
+                                       const unordered_map<string, uint64_t>& bookIndex) {
+    string out;
+    for (size_t i = begin; i < end; ++i) {
+        const User& user = *users[i];
+        putString(out, user.getName());
+        putString(out, user.getUserId());
+
+        vector<string> borrowed = user.getBorrowedBooks();
+        putVarint(out, borrowed.size());
+        for (const string& isbn : borrowed) {
+            auto book = bookIndex.find(isbn);
+            if (book != bookIndex.end()) {
+                putVarint(out, book->second + 1);
+            } else {
+                putVarint(out, 0);
+                putString(out, isbn);
+            }
+        }
+    }
+    return out;
+}
+
+string CompactCatalog::encode(const LibrarySnapshot& snapshot) {
+    vector<const Book*> books = snapshot.getAllBooks(); // triés par titre : bon partage des préfixes
+    vector<const User*> users = snapshot.getAllUsers();
+
+    vector<string> authors;
+    unordered_map<string, uint64_t> authorIds;
+    unordered_map<string, uint64_t> bookIndex;
+    for (size_t i = 0; i < books.size(); ++i) {
+        string author = books[i]->getAuthor();
+        if (authorIds.emplace(author, authors.size()).second) authors.push_back(author);
+        bookIndex.emplace(books[i]->getISBN(), i);
+    }
+    unordered_map<string, uint64_t> userIndex;
+    for (size_t i = 0; i < users.size(); ++i) userIndex.emplace(users[i]->getUserId(), i);
+
+    vector<BlockInfo> blocks;
+    vector<string> payloads;
+    for (size_t begin = 0; begin < books.size(); begin += BLOCK_SIZE) {
+        size_t end = min(books.size(), begin + BLOCK_SIZE);
+        payloads.push_back(encodeBookBlock(books, begin, end, authorIds, userIndex));
+        blocks.push_back({BlockType::BOOKS, end - begin, 0, payloads.back().size()});
+    }
+    for (size_t begin = 0; begin < users.size(); begin += BLOCK_SIZE) {
+        size_t end = min(users.size(), begin + BLOCK_SIZE);
+        payloads.push_back(encodeUserBlock(users, begin, end, bookIndex));
+        blocks.push_back({BlockType::USERS, end - begin, 0, payloads.back().size()});
+    }
+
+    // en-tête : dictionnaire des auteurs puis répertoire des blocs
+    string out(CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+    putVarint(out, authors.size());
+    for (const string& author : authors) putString(out, author);
+    putVarint(out, blocks.size());
+    for (const BlockInfo& block : blocks) {
+        out.push_back(static_cast<char>(block.type));
+        putVarint(out, block.recordCount);
+        putVarint(out, block.length);
+    }
+    for (const string& payload : payloads) out += payload;
+    return out;
+}
+
+// ---- Décodage ----
+
+void CompactCatalog::decodeBookBlock(const string& data, const BlockInfo& info,
+                                     const vector<string>& authors, DecodedBlock& result) {
+    size_t pos = info.offset;
+    size_t end = info.offset + info.length;
+    string title, suffix, isbn;
+    result.books.reserve(info.recordCount);
+    result.loanRefs.reserve(info.recordCount);
+
+    for (size_t i = 0; i < info.recordCount; ++i) {
+        uint64_t shared, authorId, loanRef;
+        if (!getVarint(data, pos, shared) || shared > title.size() || !getString(data, pos, suffix) ||
+            !getVarint(data, pos, authorId) || authorId >= authors.size() ||
+            !getIsbn(data, pos, isbn) || !getVarint(data, pos, loanRef)) {
+            return;
+        }
+        title.resize(shared);
+        title += suffix;
+
+        Book book(title, authors[authorId], isbn);
+        if (loanRef != 0) {
+            string name, id;
+            uint64_t checkout, duration;
+            if (loanRef == 1 && (!getString(data, pos, name) || !getString(data, pos, id))) return;
+            if (!getVarint(data, pos, checkout) || !getVarint(data, pos, duration)) return;
+            time_t checkoutDate = static_cast<time_t>(unzigzag(checkout));
+            // l'emprunteur connu est complété après le décodage des utilisateurs
+            book.checkOut(name, id, checkoutDate, checkoutDate + static_cast<time_t>(unzigzag(duration)));
+        }
+        result.books.push_back(move(book));
+        result.loanRefs.push_back(loanRef);
+    }
+    result.ok = (pos == end);
+}
+
+void CompactCatalog::decodeUserBlock(const string& data, const BlockInfo& info, DecodedBlock& result) {
+    size_t pos = info.offset;
+    size_t end = info.offset + info.length;
+    string name, id, isbn;
+    result.users.reserve(info.recordCount);
+    result.borrowed.reserve(info.recordCount);
+
+    for (size_t i = 0; i < info.recordCount; ++i) {
+        uint64_t count;
+        if (!getString(data, pos, name) || !getString(data, pos, id) || !getVarint(data, pos, count) ||
+            count > end - pos) {
+            return;
+        }
+        vector<pair<uint64_t, string>> refs;
+        for (uint64_t k = 0; k < count; ++k) {
+            uint64_t ref;
+            if (!getVarint(data, pos, ref)) return;
+            isbn.clear();
+            if (ref == 0 && !getString(data, pos, isbn)) return;
+            refs.emplace_back(ref, isbn);
+        }
+        result.users.emplace_back(name, id);
+        result.borrowed.push_back(move(refs));
+    }
+    result.ok = (pos == end);
+}
+
+bool CompactCatalog::decode(const string& data, vector<Book>& books, vector<User>& users) {
+    if (data.size() < sizeof(CATALOG_MAGIC) ||
+        !equal(CATALOG_MAGIC, CATALOG_MAGIC + sizeof(CATALOG_MAGIC), data.begin())) {
+        return false;
+    }
+
+    size_t pos = sizeof(CATALOG_MAGIC);
+    uint64_t n;
+    vector<string> authors;
+    if (!getVarint(data, pos, n) || n > data.size()) return false;
+    authors.resize(n);
+    for (string& author : authors) {
+        if (!getString(data, pos, author)) return false;
+    }
+
+    if (!getVarint(data, pos, n) || n > data.size()) return false;
+    vector<BlockInfo> blocks(n);
+    for (BlockInfo& block : blocks) {
+        uint64_t count, length;
+        if (pos >= data.size()) return false;
+        uint8_t type = static_cast<uint8_t>(data[pos++]);
+        if (type > static_cast<uint8_t>(BlockType::USERS) || !getVarint(data, pos, count) ||
+            !getVarint(data, pos, length) || count > length) {
+            return false;
+        }
+        block = {static_cast<BlockType>(type), static_cast<size_t>(count), 0, static_cast<size_t>(length)};
+    }
+    for (BlockInfo& block : blocks) {
+        if (block.length > data.size() - pos) return false;
+        block.offset = pos;
+        pos += block.length;
+    }
+
+    // chaque bloc se décode seul : une tâche par bloc
+    vector<DecodedBlock> decoded(blocks.size());
+    vector<function<void()>> tasks;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        tasks.push_back([&data, &blocks, &authors, &decoded, i]() {
+            if (blocks[i].type == BlockType::BOOKS) {
+                decodeBookBlock(data, blocks[i], authors, decoded[i]);
+            } else {
+                decodeUserBlock(data, blocks[i], decoded[i]);
+            }
+        });
+    }
+    ThreadPool::shared().runAll(tasks);
+
+    books.clear();
+    users.clear();
+    for (const DecodedBlock& block : decoded) {
+        if (!block.ok) return false;
+    }
+    for (DecodedBlock& block : decoded) {
+        for (Book& book : block.books) books.push_back(move(book));
+        for (User& user : block.users) users.push_back(move(user));
+    }
+
+    // résolution des références (prêts -> utilisateurs, utilisateurs -> livres)
+    size_t bookRank = 0, userRank = 0;
+    for (const DecodedBlock& block : decoded) {
+        for (uint64_t ref : block.loanRefs) {
+            Book& book = books[bookRank++];
+            if (ref < 2) continue;
+            if (ref - 2 >= users.size()) return false;
+            book.setBorrowerName(users[ref - 2].getName());
+            book.setBorrowerId(users[ref - 2].getUserId());
+        }
+        for (const auto& borrowed : block.borrowed) {
+            User& user = users[userRank++];
+            for (const auto& ref : borrowed) {
+                if (ref.first > books.size()) return false;
+                user.borrowBook(ref.first == 0 ? ref.second : books[ref.first - 1].getISBN());
+            }
+        }
+    }
+    return true;
+}
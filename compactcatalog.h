@@ -0,0 +1,62 @@
+#ifndef COMPACTCATALOG_H
+#define COMPACTCATALOG_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "library.h"
+
+using namespace std;
+
+// Format binaire compact du catalogue (livres et utilisateurs dans un seul fichier).
+//  - les livres sont triés par titre et découpés en blocs ; dans un bloc, chaque
+//    titre ne garde que ce qui diffère du précédent (front coding) ;
+//  - les auteurs sont remplacés par un numéro dans un dictionnaire commun ;
+//  - les ISBN numériques sont stockés comme entiers (varint) ;
+//  - un prêt pointe vers l'utilisateur par son numéro, et un utilisateur vers
+//    ses livres par leur rang dans le catalogue.
+// Chaque bloc se décode seul : le chargement décode tous les blocs en parallèle.
+class CompactCatalog {
+public:
+    static const size_t BLOCK_SIZE = 1024; // enregistrements par bloc
+
+    // Encode tous les livres et utilisateurs d'un instantané de la bibliothèque
+    static string encode(const LibrarySnapshot& snapshot);
+
+    // Décode les livres (dans l'ordre du catalogue) et les utilisateurs
+    // (le contenu des vecteurs est remplacé). Retourne false si les données
+    // sont invalides.
+    static bool decode(const string& data, vector<Book>& books, vector<User>& users);
+
+private:
+    enum class BlockType : uint8_t { BOOKS = 0, USERS = 1 };
+
+    struct BlockInfo {
+        BlockType type;
+        size_t recordCount;
+        size_t offset;   // dans les données
+        size_t length;
+    };
+
+    // Résultat du décodage d'un bloc, avant la résolution des références
+    struct DecodedBlock {
+        vector<Book> books;
+        vector<uint64_t> loanRefs;            // 0 : aucun, 1 : emprunteur inconnu, k + 2 : utilisateur k
+        vector<User> users;
+        vector<vector<pair<uint64_t, string>>> borrowed; // (k + 1 : livre de rang k) ou (0, ISBN)
+        bool ok = false;
+    };
+
+    static string encodeBookBlock(const vector<const Book*>& books, size_t begin, size_t end,
+                                  const unordered_map<string, uint64_t>& authorIds,
+                                  const unordered_map<string, uint64_t>& userIndex);
+    static string encodeUserBlock(const vector<const User*>& users, size_t begin, size_t end,
+                                  const unordered_map<string, uint64_t>& bookIndex);
+    static void decodeBookBlock(const string& data, const BlockInfo& info, const vector<string>& authors,
+                                DecodedBlock& result);
+    static void decodeUserBlock(const string& data, const BlockInfo& info, DecodedBlock& result);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef COWVECTOR_H
+#define COWVECTOR_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+
+#include "memoryusage.h"
+
+using namespace std;
+
+// Vecteur d'objets partagés, découpé en morceaux, avec copie à l'écriture.
+// Copier le vecteur ne copie que les pointeurs vers les morceaux (n / 512) :
+// c'est ce qui rend les instantanés de la bibliothèque peu coûteux. Une
+// modification ne recopie que le morceau touché, puis l'objet lui-même, et
+// seulement s'ils sont encore partagés avec une copie.
+// Les lectures passent par des pointeurs partagés : une copie garde ses
+// objets en vie même après une suppression dans l'original.
+template <typename T>
+class CowVector {
+public:
+    static const size_t CHUNK_SIZE = 512;
+
+private:
+    using Chunk = vector<shared_ptr<T>>;
+    vector<shared_ptr<Chunk>> chunks;
+    size_t count = 0;
+
+    // Own chunk c before changing it (copy it if another vector shares it)
+    Chunk& editChunk(size_t c) {
+        if (chunks[c].use_count() > 1) {
+            chunks[c] = make_shared<Chunk>(*chunks[c]);
+        }
+        return *chunks[c];
+    }
+
+public:
+    class const_iterator {
+    private:
+        const CowVector* owner;
+        size_t position;
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = shared_ptr<T>;
+        using difference_type = ptrdiff_t;
+        using pointer = const shared_ptr<T>*;
+        using reference = const shared_ptr<T>&;
+
+        const_iterator(const CowVector* owner, size_t position) : owner(owner), position(position) {}
+        const shared_ptr<T>& operator*() const { return (*owner)[position]; }
+        const shared_ptr<T>* operator->() const { return &(*owner)[position]; }
+        const_iterator& operator++() {
+            ++position;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++position;
+            return previous;
+        }
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+    };
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const shared_ptr<T>& operator[](size_t index) const {
+        return (*chunks[index / CHUNK_SIZE])[index % CHUNK_SIZE];
+    }
+
+    const shared_ptr<T>& back() const { return (*this)[count - 1]; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    void push_back(shared_ptr<T> item) {
+        if (count % CHUNK_SIZE == 0) {
+            chunks.push_back(make_shared<Chunk>());
+            chunks.back()->reserve(CHUNK_SIZE);
+        }
+        editChunk(chunks.size() - 1).push_back(move(item));
+        count++;
+    }
+
+    // Object at this position, ready to be modified without affecting copies
+    T& edit(size_t index) {
+        shared_ptr<T>& item = editChunk(index / CHUNK_SIZE)[index % CHUNK_SIZE];
+        if (item.use_count() > 1) {
+            item = make_shared<T>(*item);
+        }
+        return *item;
+    }
+
+    // Remove one position: the last object takes its place (the order is not
+    // kept), so at most two chunks are touched
+    void erase(size_t index) {
+        count--;
+        if (index != count) {
+            editChunk(index / CHUNK_SIZE)[index % CHUNK_SIZE] = (*this)[count];
+        }
+        Chunk& last = editChunk(count / CHUNK_SIZE);
+        last.pop_back();
+        if (last.empty()) chunks.pop_back();
+    }
+
+    void clear() {
+        chunks.clear();
+        count = 0;
+    }
+
+    // Pointer storage only: chunk table, chunks, and the control block in
+    // front of each object (the objects themselves are not counted)
+    size_t heapBytes() const {
+        size_t bytes = chunks.capacity() * sizeof(shared_ptr<Chunk>) + count * SHARED_CONTROL_BYTES;
+        for (const auto& chunk : chunks) {
+            bytes += SHARED_CONTROL_BYTES + sizeof(Chunk) + chunk->capacity() * sizeof(shared_ptr<T>);
+        }
+        return bytes;
+    }
+};
+
+#endif
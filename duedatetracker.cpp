@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <queue>
+
+#include "duedatetracker.h"
+#include "memoryusage.h"
+
+using namespace std;
+
+// Comparateur pour std::push_heap : un tas-min sur la date de retour
+bool DueDateTracker::later(const Entry& a, const Entry& b) {
+    if (a.dueDate != b.dueDate) return a.dueDate > b.dueDate;
+    if (a.isbn != b.isbn) return a.isbn > b.isbn;
+    return a.loanSequence > b.loanSequence;
+}
+
+void DueDateTracker::push(time_t dueDate, const string& isbn, uint64_t loanSequence) {
+    heap.push_back({dueDate, isbn, loanSequence});
+    push_heap(heap.begin(), heap.end(), later);
+}
+
+void DueDateTracker::markStale() { staleCount++; }
+
+void DueDateTracker::clear() {
+    heap.clear();
+    staleCount = 0;
+}
+
+size_t DueDateTracker::size() const { return heap.size() - min(staleCount, heap.size()); }
+
+size_t DueDateTracker::heapBytes() const {
+    size_t bytes = heap.capacity() * sizeof(Entry);
+    for (const Entry& entry : heap) bytes += stringHeapBytes(entry.isbn);
+    return bytes;
+}
+
+// Parcours du tas en profondeur : on ne descend sous un noeud que si son
+// échéance est dépassée, donc seuls les prêts en retard (et leurs enfants
+// directs) sont visités.
+vector<DueDateTracker::Entry> DueDateTracker::overdue(time_t now, const Validator& isValid) const {
+    vector<Entry> results;
+    vector<size_t> pending;
+    if (!heap.empty()) pending.push_back(0);
+
+    while (!pending.empty()) {
+        size_t i = pending.back();
+        pending.pop_back();
+        if (heap[i].dueDate >= now) continue;
+
+        if (isValid(heap[i])) results.push_back(heap[i]);
+        if (2 * i + 1 < heap.size()) pending.push_back(2 * i + 1);
+        if (2 * i + 2 < heap.size()) pending.push_back(2 * i + 2);
+    }
+
+    sort(results.begin(), results.end(), [](const Entry& a, const Entry& b) {
+        return later(b, a);
+    });
+    return results;
+}
+
+// Parcours par ordre d'échéance avec une petite file de priorité sur les
+// positions du tas : on n'explore que les noeuds candidats.
+vector<DueDateTracker::Entry> DueDateTracker::nextDue(size_t n, const Validator& isValid) const {
+    vector<Entry> results;
+    auto cmp = [this](size_t a, size_t b) { return later(heap[a], heap[b]); };
+    priority_queue<size_t, vector<size_t>, decltype(cmp)> frontier(cmp);
+    if (!heap.empty()) frontier.push(0);
+
+    while (!frontier.empty() && results.size() < n) {
+        size_t i = frontier.top();
+        frontier.pop();
+
+        if (isValid(heap[i])) results.push_back(heap[i]);
+        if (2 * i + 1 < heap.size()) frontier.push(2 * i + 1);
+        if (2 * i + 2 < heap.size()) frontier.push(2 * i + 2);
+    }
+    return results;
+}
+
+void DueDateTracker::compactIfNeeded(const Validator& isValid) {
+    if (heap.size() < 64 || staleCount * 2 < heap.size()) return;
+
+    vector<Entry> kept;
+    kept.reserve(heap.size() - min(staleCount, heap.size()));
+    for (const Entry& e : heap) {
+        if (isValid(e)) kept.push_back(e);
+    }
+    make_heap(kept.begin(), kept.end(), later);
+    heap.swap(kept);
+    staleCount = 0;
+}
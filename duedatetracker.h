@@ -0,0 +1,47 @@
+#ifndef DUEDATETRACKER_H
+#define DUEDATETRACKER_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <functional>
+
+using namespace std;
+
+// Tas-min des prêts en cours, ordonné par date de retour.
+// Un retour ne retire pas l'entrée du tas (ce serait O(n)) : elle devient
+// périmée et est ignorée grâce au test de validité fourni par la bibliothèque.
+// Le tas est compacté quand les entrées périmées deviennent majoritaires.
+class DueDateTracker {
+public:
+    struct Entry {
+        time_t dueDate;
+        string isbn;
+        uint64_t loanSequence;  // numéro du prêt (voir Book::getLoanSequence)
+    };
+    using Validator = function<bool(const Entry&)>;
+
+private:
+    vector<Entry> heap;   // heap[0] = prochaine échéance
+    size_t staleCount = 0;
+
+    static bool later(const Entry& a, const Entry& b);
+
+public:
+    void push(time_t dueDate, const string& isbn, uint64_t loanSequence);
+    void markStale();
+    void clear();
+    size_t size() const;
+    size_t heapBytes() const;
+
+    // Prêts en retard (échéance < now), triés par échéance : O(k log k)
+    vector<Entry> overdue(time_t now, const Validator& isValid) const;
+    // Les n prochaines échéances valides : O(n log n)
+    vector<Entry> nextDue(size_t n, const Validator& isValid) const;
+
+    // Retire les entrées périmées si elles dominent le tas
+    void compactIfNeeded(const Validator& isValid);
+};
+
+#endif
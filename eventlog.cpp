@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <climits>
+
+#include "eventlog.h"
+#include "varint.h"
+#include "memoryusage.h"
+
+using namespace std;
+
+static const char BLOCK_MAGIC[4] = {'E', 'V', 'B', '1'};
+
+// Décalage du fuseau (DST compris) à l'instant timestamp, en secondes
+static int64_t localOffsetAt(int64_t timestamp) {
+    time_t t = static_cast<time_t>(timestamp);
+    tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    // heure locale relue comme si elle était UTC (jours depuis 1970, civil)
+    int64_t y = local.tm_year + 1900 - (local.tm_mon < 2);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t mp = (local.tm_mon + 9) % 12;
+    int64_t doy = (153 * mp + 2) / 5 + local.tm_mday - 1;
+    int64_t days = era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+    int64_t asUtc = days * 86400 + local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+    return asUtc - timestamp;
+}
+
+// ---- Enregistrement ----
+
+uint32_t EventLog::intern(const string& value, vector<string>& dict, unordered_map<string, uint32_t>& lookup) {
+    auto it = lookup.find(value);
+    if (it != lookup.end()) return it->second;
+    uint32_t id = dict.size();
+    dict.push_back(value);
+    lookup.emplace(value, id);
+    return id;
+}
+
+void EventLog::record(time_t timestamp, const string& isbn, const string& userId, Action action) {
+    timestamps.push_back(static_cast<int64_t>(timestamp));
+    isbnIds.push_back(intern(isbn, isbnDict, isbnLookup));
+    userIds.push_back(intern(userId, userDict, userLookup));
+    actions.push_back(static_cast<uint8_t>(action));
+}
+
+void EventLog::clear() {
+    timestamps.clear();
+    isbnIds.clear();
+    userIds.clear();
+    actions.clear();
+    isbnDict.clear();
+    userDict.clear();
+    isbnLookup.clear();
+    userLookup.clear();
+    persistedEvents = persistedIsbns = persistedUsers = 0;
+}
+
+size_t EventLog::size() const { return timestamps.size(); }
+
+// Colonnes, dictionnaires et tables de recherche
+size_t EventLog::heapBytes() const {
+    size_t bytes = vectorHeapBytes(timestamps) + vectorHeapBytes(isbnIds) + vectorHeapBytes(userIds) +
+                   vectorHeapBytes(actions) + vectorHeapBytes(isbnDict) + vectorHeapBytes(userDict) +
+                   hashTableHeapBytes(isbnLookup) + hashTableHeapBytes(userLookup);
+    for (const auto& entry : isbnLookup) bytes += stringHeapBytes(entry.first);
+    for (const auto& entry : userLookup) bytes += stringHeapBytes(entry.first);
+    return bytes;
+}
+size_t EventLog::pendingEvents() const { return timestamps.size() - persistedEvents; }
+
+// ---- Persistance ----
+
+// Bloc : "EVB1", longueur, nouvelles entrées des dictionnaires, nombre
+// d'événements, puis chaque colonne précédée de sa taille en octets
+bool EventLog::appendTo(ostream& out) {
+    if (pendingEvents() == 0) return true;
+
+    string payload;
+    putVarint(payload, isbnDict.size() - persistedIsbns);
+    for (size_t i = persistedIsbns; i < isbnDict.size(); ++i) putString(payload, isbnDict[i]);
+    putVarint(payload, userDict.size() - persistedUsers);
+    for (size_t i = persistedUsers; i < userDict.size(); ++i) putString(payload, userDict[i]);
+
+    size_t count = pendingEvents();
+    putVarint(payload, count);
+
+    string column;
+    int64_t previous = 0;
+    for (size_t i = persistedEvents; i < timestamps.size(); ++i) {
+        putVarint(column, zigzag(timestamps[i] - previous));
+        previous = timestamps[i];
+    }
+    putString(payload, column);
+
+    column.clear();
+    for (size_t i = persistedEvents; i < isbnIds.size(); ++i) putVarint(column, isbnIds[i]);
+    putString(payload, column);
+
+    column.clear();
+    for (size_t i = persistedEvents; i < userIds.size(); ++i) putVarint(column, userIds[i]);
+    putString(payload, column);
+
+    column.assign((count + 7) / 8, '\0');
+    for (size_t i = 0; i < count; ++i) {
+        if (actions[persistedEvents + i]) column[i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+    putString(payload, column);
+
+    string header(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    putVarint(header, payload.size());
+    out.write(header.data(), header.size());
+    out.write(payload.data(), payload.size());
+    if (!out) return false;
+
+    persistedEvents = timestamps.size();
+    persistedIsbns = isbnDict.size();
+    persistedUsers = userDict.size();
+    return true;
+}
+
+// Decode a whole block before adding anything: a corrupt block leaves the log unchanged
+bool EventLog::readBlock(istream& in) {
+    char magic[sizeof(BLOCK_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), BLOCK_MAGIC)) return false;
+
+    // longueur du bloc (varint lu octet par octet)
+    uint64_t length = 0;
+    for (int shift = 0;; shift += 7) {
+        int c = in.get();
+        if (c == EOF || shift >= 64) return false;
+        length |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) break;
+    }
+
+    string payload;
+    try {
+        payload.resize(length);
+    } catch (const exception&) {
+        return false; // longueur aberrante
+    }
+    if (!in.read(&payload[0], length)) return false; // bloc tronqué
+
+    size_t pos = 0;
+    uint64_t n;
+    vector<string> newIsbns, newUsers;
+    if (!getVarint(payload, pos, n) || n > payload.size()) return false;
+    newIsbns.resize(n);
+    for (string& value : newIsbns) {
+        if (!getString(payload, pos, value)) return false;
+    }
+    if (!getVarint(payload, pos, n) || n > payload.size()) return false;
+    newUsers.resize(n);
+    for (string& value : newUsers) {
+        if (!getString(payload, pos, value)) return false;
+    }
+
+    uint64_t count;
+    string tsCol, isbnCol, userCol, actionCol;
+    if (!getVarint(payload, pos, count) || !getString(payload, pos, tsCol) ||
+        !getString(payload, pos, isbnCol) || !getString(payload, pos, userCol) ||
+        !getString(payload, pos, actionCol) || count > tsCol.size() || actionCol.size() < (count + 7) / 8) {
+        return false;
+    }
+
+    const size_t isbnLimit = isbnDict.size() + newIsbns.size();
+    const size_t userLimit = userDict.size() + newUsers.size();
+    vector<int64_t> newTimestamps(count);
+    vector<uint32_t> newIsbnIds(count), newUserIds(count);
+    size_t tsPos = 0, isbnPos = 0, userPos = 0;
+    int64_t previous = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta, isbnId, userId;
+        if (!getVarint(tsCol, tsPos, delta) || !getVarint(isbnCol, isbnPos, isbnId) ||
+            !getVarint(userCol, userPos, userId) || isbnId >= isbnLimit || userId >= userLimit) {
+            return false;
+        }
+        previous += unzigzag(delta);
+        newTimestamps[i] = previous;
+        newIsbnIds[i] = static_cast<uint32_t>(isbnId);
+        newUserIds[i] = static_cast<uint32_t>(userId);
+    }
+
+    for (const string& value : newIsbns) intern(value, isbnDict, isbnLookup);
+    for (const string& value : newUsers) intern(value, userDict, userLookup);
+    timestamps.insert(timestamps.end(), newTimestamps.begin(), newTimestamps.end());
+    isbnIds.insert(isbnIds.end(), newIsbnIds.begin(), newIsbnIds.end());
+    userIds.insert(userIds.end(), newUserIds.begin(), newUserIds.end());
+    for (uint64_t i = 0; i < count; ++i) actions.push_back((actionCol[i / 8] >> (i % 8)) & 1);
+    return true;
+}
+
+// Load every complete block and return the offset just after the last one.
+// Anything past it (a block torn by a crash) must be cut before appending.
+uint64_t EventLog::loadFrom(istream& in) {
+    clear();
+    uint64_t validEnd = 0;
+    while (in.peek() != EOF && readBlock(in)) {
+        validEnd = static_cast<uint64_t>(in.tellg());
+    }
+
+    persistedEvents = timestamps.size();
+    persistedIsbns = isbnDict.size();
+    persistedUsers = userDict.size();
+    return validEnd;
+}
+
+// ---- Analyses ----
+
+// Les ISBN les plus empruntés
+vector<pair<string, size_t>> EventLog::mostBorrowed(size_t count) const {
+    vector<size_t> counts(isbnDict.size(), 0);
+    const size_t n = isbnIds.size();
+    for (size_t i = 0; i < n; ++i) {
+        counts[isbnIds[i]] += (actions[i] == static_cast<uint8_t>(Action::CHECKOUT));
+    }
+
+    vector<pair<string, size_t>> top;
+    for (size_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] > 0) top.emplace_back(isbnDict[id], counts[id]);
+    }
+    size_t keep = min(count, top.size());
+    partial_sort(top.begin(), top.begin() + keep, top.end(),
+        [](const pair<string, size_t>& a, const pair<string, size_t>& b) {
+            if (a.second != b.second) return a.second > b.second;
+            return a.first < b.first;
+        });
+    top.resize(keep);
+    return top;
+}
+
+// Nombre d'emprunts par heure de la journée (heure locale)
+array<size_t, 24> EventLog::checkoutsByHour() const {
+    array<size_t, 24> hours{};
+    // le décalage change au passage à l'heure d'été : on le recalcule pour
+    // chaque heure UTC rencontrée (les événements sont presque triés)
+    int64_t cachedHour = INT64_MIN;
+    int64_t offset = 0;
+    const size_t n = timestamps.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (actions[i] != static_cast<uint8_t>(Action::CHECKOUT)) continue;
+        int64_t utcHour = timestamps[i] >= 0 ? timestamps[i] / 3600 : (timestamps[i] - 3599) / 3600;
+        if (utcHour != cachedHour) {
+            cachedHour = utcHour;
+            offset = localOffsetAt(timestamps[i]);
+        }
+        int64_t secondsOfDay = ((timestamps[i] + offset) % 86400 + 86400) % 86400;
+        hours[secondsOfDay / 3600]++;
+    }
+    return hours;
+}
+
+// Durée moyenne entre un emprunt et le retour suivant du même livre
+double EventLog::averageLoanDurationSeconds() const {
+    vector<int64_t> openedAt(isbnDict.size(), -1);
+    double total = 0;
+    size_t loans = 0;
+    const size_t n = timestamps.size();
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t id = isbnIds[i];
+        if (actions[i] == static_cast<uint8_t>(Action::CHECKOUT)) {
+            openedAt[id] = timestamps[i];
+        } else if (openedAt[id] >= 0) {
+            total += timestamps[i] - openedAt[id];
+            loans++;
+            openedAt[id] = -1;
+        }
+    }
+    return loans ? total / loans : 0.0;
+}
+
+// Tous les événements d'un utilisateur, en ordre chronologique
+vector<EventLog::Event> EventLog::userHistory(const string& userId) const {
+    vector<Event> history;
+    auto it = userLookup.find(userId);
+    if (it == userLookup.end()) return history;
+
+    const uint32_t id = it->second;
+    const size_t n = userIds.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (userIds[i] == id) {
+            history.push_back({static_cast<time_t>(timestamps[i]), isbnDict[isbnIds[i]],
+                               userDict[id], static_cast<Action>(actions[i])});
+        }
+    }
+    return history;
+}
@@ -0,0 +1,70 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+
+// Journal des emprunts et retours, stocké en colonnes.
+// En mémoire : une colonne par champ (dates, ISBN, utilisateur, action), les
+// ISBN et ID d'utilisateurs étant remplacés par des numéros de dictionnaire.
+// Sur disque : le fichier est en ajout seulement ; chaque sauvegarde écrit un
+// bloc compressé avec les nouvelles entrées de dictionnaire et les nouveaux
+// événements (dates en delta + varint, ids en varint, actions sur 1 bit).
+class EventLog {
+public:
+    enum class Action : uint8_t { CHECKOUT = 0, RETURN = 1 };
+
+    struct Event {
+        time_t timestamp;
+        string isbn;
+        string userId;
+        Action action;
+    };
+
+private:
+    // colonnes
+    vector<int64_t> timestamps;
+    vector<uint32_t> isbnIds;
+    vector<uint32_t> userIds;
+    vector<uint8_t> actions;
+
+    // dictionnaires
+    vector<string> isbnDict;
+    vector<string> userDict;
+    unordered_map<string, uint32_t> isbnLookup;
+    unordered_map<string, uint32_t> userLookup;
+
+    // ce qui est déjà écrit sur disque
+    size_t persistedEvents = 0;
+    size_t persistedIsbns = 0;
+    size_t persistedUsers = 0;
+
+    static uint32_t intern(const string& value, vector<string>& dict, unordered_map<string, uint32_t>& lookup);
+    bool readBlock(istream& in);
+
+public:
+    void record(time_t timestamp, const string& isbn, const string& userId, Action action);
+    void clear();
+    size_t size() const;
+    size_t heapBytes() const;
+    size_t pendingEvents() const;
+
+    // Persistance par blocs ; loadFrom retourne la fin du dernier bloc valide
+    bool appendTo(ostream& out);
+    uint64_t loadFrom(istream& in);
+
+    // Analyses (parcours des colonnes)
+    vector<pair<string, size_t>> mostBorrowed(size_t count) const;
+    array<size_t, 24> checkoutsByHour() const;
+    double averageLoanDurationSeconds() const;
+    vector<Event> userHistory(const string& userId) const;
+};
+
+#endif
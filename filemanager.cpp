@@ -1,7 +1,13 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <sstream>
+#include <future>
+#include <algorithm>
+#include <chrono>
 #include "filemanager.h"
+#include "compactcatalog.h"
+#include "backupstore.h"
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -22,30 +28,71 @@ FileManager::FileManager(const string& booksFile, const string& usersFile) {
         booksFileName = "books.txt";
         usersFileName = "users.txt";
     }
+    // les réservations sont à côté des livres
+    holdsFileName = (fs::path(booksFileName).parent_path() / "holds.txt").string();
+    eventsFileName = (fs::path(booksFileName).parent_path() / "events.log").string();
+    catalogFileName = (fs::path(booksFileName).parent_path() / "catalog.bin").string();
+    backupDirectory = (fs::path(booksFileName).parent_path() / "backups").string();
+}
+
+// Lazy files of books (key: ISBN; summary: availability and due date, for
+// the statistics) and of users (key: ID); the index layout depends on these
+static unique_ptr<LazyRecordFile> lazyBookRecords(const string& path) {
+    return make_unique<LazyRecordFile>(path, 2, LazyRecordFile::Summary{3, "1", 7});
+}
+
+static unique_ptr<LazyRecordFile> lazyUserRecords(const string& path) {
+    return make_unique<LazyRecordFile>(path, 1);
 }
 
 // Save all library data
 bool FileManager::saveLibraryData(Library& library) {
-    return saveBooksToFile(library) && saveUsersToFile(library);
+    bool catalogSaved = (lazyMode && !compactMode) ? saveLazyCatalog(library) : saveSnapshot(library.snapshot());
+    // mode paresseux : index refait tout de suite, le prochain démarrage reste immédiat
+    if (catalogSaved && lazyMode && !compactMode) {
+        lazyBookRecords(booksFileName)->open();
+        lazyUserRecords(usersFileName)->open();
+    }
+    return catalogSaved && saveEventLog(library);
+}
+
+// Save the catalog and the holds of a snapshot; the library it comes from
+// can keep changing meanwhile, even from another thread
+bool FileManager::saveSnapshot(const LibrarySnapshot& snapshot) {
+    bool catalogSaved = compactMode ? saveCompactCatalog(snapshot)
+                                    : saveBooksToFile(snapshot) && saveUsersToFile(snapshot);
+    return catalogSaved && saveHoldsToFile(snapshot);
 }
 
 // Load all library data
 bool FileManager::loadLibraryData(Library& library) {
+    // mode compact : catalog.bin s'il existe, sinon les fichiers texte
+    if (compactMode && loadCompactCatalog(library)) {
+        loadHoldsFromFile(library);
+        loadEventLog(library);
+        return true;
+    }
+    // mode paresseux : rien n'est décodé avant le premier accès
+    if (lazyMode && !compactMode && openLazyRecords(library)) {
+        loadHoldsFromFile(library);
+        loadEventLog(library);
+        return true;
+    }
     bool booksLoaded = loadBooksFromFile(library);
     bool usersLoaded = loadUsersFromFile(library);
+    loadHoldsFromFile(library); // optionnel
+    loadEventLog(library);      // optionnel
     return booksLoaded || usersLoaded; // Return true if at least one file was loaded
 }
 
-// Save books to file
-bool FileManager::saveBooksToFile(Library& library) {
-    ofstream file(booksFileName);
+// Write the books of a snapshot to the given file
+bool FileManager::writeBooksFile(const LibrarySnapshot& snapshot, const string& path) {
+    ofstream file(path);
     if (!file.is_open()) {
-        cout << "Erreur : Impossible d'ouvrir " << booksFileName << " en écriture.\n";
         return false;
     }
     
-    auto books = library.getAllBooks();
-    for (Book* book : books) {
+    for (const Book* book : snapshot.getAllBooks()) {
         file << book->toFileFormat() << "\n";
     }
     
@@ -53,16 +100,14 @@ bool FileManager::saveBooksToFile(Library& library) {
     return true;
 }
 
-// Save users to file
-bool FileManager::saveUsersToFile(Library& library) {
-    ofstream file(usersFileName);
+// Write the users of a snapshot to the given file
+bool FileManager::writeUsersFile(const LibrarySnapshot& snapshot, const string& path) {
+    ofstream file(path);
     if (!file.is_open()) {
-        cout << "Erreur : Impossible d'ouvrir " << usersFileName << " en écriture.\n";
         return false;
     }
     
-    auto users = library.getAllUsers();
-    for (User* user : users) {
+    for (const User* user : snapshot.getAllUsers()) {
         file << user->toFileFormat() << "\n";
     }
     
@@ -70,73 +115,543 @@ bool FileManager::saveUsersToFile(Library& library) {
     return true;
 }
 
-// Load books from file
-bool FileManager::loadBooksFromFile(Library& library) {
-    ifstream file(booksFileName);
+// Parse the books of the given file (false if it cannot be opened)
+bool FileManager::parseBooksFile(const string& path, vector<Book>& books) {
+    ifstream file(path);
     if (!file.is_open()) {
-        cout << "Aucun fichier de livres existant trouvé. Démarrage avec une bibliothèque vide.\n";
         return false;
     }
     
     string line;
-    int count = 0;
     while (getline(file, line)) {
         if (!line.empty()) {
             Book book;
             book.fromFileFormat(line);
-            library.addBook(book);
-            count++;
+            books.push_back(move(book));
         }
     }
     
     file.close();
-    cout << "Chargé " << count << " livre(s) depuis le fichier.\n";
     return true;
 }
 
-// Load users from file
-bool FileManager::loadUsersFromFile(Library& library) {
-    ifstream file(usersFileName);
+// Parse the users of the given file (false if it cannot be opened)
+bool FileManager::parseUsersFile(const string& path, vector<User>& users) {
+    ifstream file(path);
     if (!file.is_open()) {
-        cout << "Aucun fichier d'utilisateurs existant trouvé. Démarrage sans utilisateurs enregistrés.\n";
         return false;
     }
     
     string line;
-    int count = 0;
     while (getline(file, line)) {
         if (!line.empty()) {
             User user;
             user.fromFileFormat(line);
-            library.addUser(user);
-            count++;
+            users.push_back(move(user));
         }
     }
     
     file.close();
+    return true;
+}
+
+// Read books from the given file (-1 if it cannot be opened)
+int FileManager::readBooksFile(Library& library, const string& path) {
+    vector<Book> books;
+    if (!parseBooksFile(path, books)) {
+        return -1;
+    }
+    for (const Book& book : books) {
+        library.addBook(book);
+    }
+    return static_cast<int>(books.size());
+}
+
+// Read users from the given file (-1 if it cannot be opened)
+int FileManager::readUsersFile(Library& library, const string& path) {
+    vector<User> users;
+    if (!parseUsersFile(path, users)) {
+        return -1;
+    }
+    for (const User& user : users) {
+        library.addUser(user);
+    }
+    return static_cast<int>(users.size());
+}
+
+// Save books to file
+bool FileManager::saveBooksToFile(const LibrarySnapshot& snapshot) {
+    if (!writeBooksFile(snapshot, booksFileName)) {
+        cout << "Erreur : Impossible d'ouvrir " << booksFileName << " en écriture.\n";
+        return false;
+    }
+    return true;
+}
+
+// Save users to file
+bool FileManager::saveUsersToFile(const LibrarySnapshot& snapshot) {
+    if (!writeUsersFile(snapshot, usersFileName)) {
+        cout << "Erreur : Impossible d'ouvrir " << usersFileName << " en écriture.\n";
+        return false;
+    }
+    return true;
+}
+
+// Load books from file
+bool FileManager::loadBooksFromFile(Library& library) {
+    int count = readBooksFile(library, booksFileName);
+    if (count < 0) {
+        cout << "Aucun fichier de livres existant trouvé. Démarrage avec une bibliothèque vide.\n";
+        return false;
+    }
+    cout << "Chargé " << count << " livre(s) depuis le fichier.\n";
+    return true;
+}
+
+// Load users from file
+bool FileManager::loadUsersFromFile(Library& library) {
+    int count = readUsersFile(library, usersFileName);
+    if (count < 0) {
+        cout << "Aucun fichier d'utilisateurs existant trouvé. Démarrage sans utilisateurs enregistrés.\n";
+        return false;
+    }
     cout << "Chargé " << count << " utilisateur(s) depuis le fichier.\n";
     return true;
 }
 
+// File pair of one shard: books.shard<N>.txt / users.shard<N>.txt
+string FileManager::shardFileName(const string& baseFile, size_t shard) const {
+    fs::path path(baseFile);
+    return (path.parent_path() / (path.stem().string() + ".shard" + to_string(shard) + path.extension().string())).string();
+}
+
+// Save every shard to its own file pair, all shards in parallel
+bool FileManager::saveShardedLibrary(ShardedLibrary& library) {
+    vector<future<bool>> pending;
+    for (size_t i = 0; i < library.getShardCount(); ++i) {
+        // instantané pris ici : l'écriture n'a plus besoin du fragment
+        LibrarySnapshot snapshot = library.getShard(i).snapshot();
+        pending.push_back(async(launch::async, [this, snapshot = move(snapshot), i]() {
+            return writeBooksFile(snapshot, shardFileName(booksFileName, i)) &&
+                   writeUsersFile(snapshot, shardFileName(usersFileName, i));
+        }));
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (!pending[i].get()) {
+            cout << "Erreur : Impossible d'écrire le fragment " << i << ".\n";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// Load every shard from its own file pair, all shards in parallel
+bool FileManager::loadShardedLibrary(ShardedLibrary& library) {
+    vector<future<pair<int, int>>> pending;
+    for (size_t i = 0; i < library.getShardCount(); ++i) {
+        pending.push_back(async(launch::async, [this, &library, i]() {
+            Library& shard = library.getShard(i);
+            return make_pair(readBooksFile(shard, shardFileName(booksFileName, i)),
+                             readUsersFile(shard, shardFileName(usersFileName, i)));
+        }));
+    }
+
+    int books = 0, users = 0;
+    bool anyLoaded = false;
+    for (auto& f : pending) {
+        pair<int, int> counts = f.get();
+        if (counts.first >= 0 || counts.second >= 0) anyLoaded = true;
+        books += max(counts.first, 0);
+        users += max(counts.second, 0);
+    }
+    cout << "Chargé " << books << " livre(s) et " << users << " utilisateur(s) depuis "
+         << library.getShardCount() << " fragment(s).\n";
+    return anyLoaded;
+}
+
+// Save hold queues: one line per book, "isbn|USR001,USR002"
+bool FileManager::saveHoldsToFile(const LibrarySnapshot& snapshot) {
+    ofstream file(holdsFileName);
+    if (!file.is_open()) {
+        cout << "Erreur : Impossible d'ouvrir " << holdsFileName << " en écriture.\n";
+        return false;
+    }
+
+    for (const auto& hold : snapshot.getAllHolds()) {
+        file << hold.first << "|";
+        for (size_t i = 0; i < hold.second.size(); ++i) {
+            file << hold.second[i];
+            if (i < hold.second.size() - 1) file << ",";
+        }
+        file << "\n";
+    }
+
+    file.close();
+    return true;
+}
+
+// Load hold queues (the file is optional)
+bool FileManager::loadHoldsFromFile(Library& library) {
+    ifstream file(holdsFileName);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    string line;
+    int count = 0;
+    while (getline(file, line)) {
+        size_t sep = line.find('|');
+        if (line.empty() || sep == string::npos) continue;
+
+        string isbn = line.substr(0, sep);
+        stringstream ids(line.substr(sep + 1));
+        string userId;
+        while (getline(ids, userId, ',')) {
+            if (!userId.empty()) {
+                library.enqueueHold(isbn, userId);
+                count++;
+            }
+        }
+    }
+
+    file.close();
+    cout << "Chargé " << count << " réservation(s) depuis le fichier.\n";
+    return true;
+}
+
+// Append the new loan events as one compressed block
+bool FileManager::saveEventLog(Library& library) {
+    if (library.getEventLog().pendingEvents() == 0) return true;
+
+    error_code ec;
+    uintmax_t previousSize = fs::exists(eventsFileName, ec) ? fs::file_size(eventsFileName, ec) : 0;
+    if (ec) previousSize = 0;
+
+    ofstream file(eventsFileName, ios::binary | ios::app);
+    bool written = file.is_open() && library.getEventLog().appendTo(file);
+    file.close();
+    if (!written || !file) {
+        // un bloc à moitié écrit masquerait tous les blocs suivants
+        if (fs::exists(eventsFileName, ec)) fs::resize_file(eventsFileName, previousSize, ec);
+        cout << "Erreur : Impossible d'écrire dans " << eventsFileName << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// Load the loan history (the file is optional)
+bool FileManager::loadEventLog(Library& library) {
+    ifstream file(eventsFileName, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    uint64_t validEnd = library.getEventLog().loadFrom(file);
+    file.close();
+
+    // fin illisible (bloc interrompu par un arrêt brutal) : on la retire pour
+    // que les prochains blocs soient ajoutés à la suite d'un bloc valide
+    error_code ec;
+    uintmax_t size = fs::file_size(eventsFileName, ec);
+    if (!ec && size > validEnd) {
+        fs::resize_file(eventsFileName, validEnd, ec);
+        cout << "Historique : " << (size - validEnd) << " octet(s) illisible(s) retiré(s) en fin de fichier.\n";
+    }
+
+    cout << "Chargé " << library.getEventLog().size() << " événement(s) d'emprunt depuis l'historique.\n";
+    return true;
+}
+
+void FileManager::setCompactMode(bool enabled) { compactMode = enabled; }
+bool FileManager::isCompactMode() const { return compactMode; }
+
+// Save books and users to the compact catalog
+bool FileManager::saveCompactCatalog(const LibrarySnapshot& snapshot) {
+    string data = CompactCatalog::encode(snapshot);
+    ofstream file(catalogFileName, ios::binary);
+    if (!file.is_open() || !file.write(data.data(), data.size())) {
+        cout << "Erreur : Impossible d'écrire dans " << catalogFileName << ".\n";
+        return false;
+    }
+    return true;
+}
+
+// Read the whole compact catalog file (false if it cannot be opened)
+static bool readCatalogBytes(const string& path, string& data) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    return true;
+}
+
+// Load books and users from the compact catalog
+bool FileManager::loadCompactCatalog(Library& library) {
+    string data;
+    if (!readCatalogBytes(catalogFileName, data)) {
+        return false;
+    }
+
+    vector<Book> books;
+    vector<User> users;
+    if (!CompactCatalog::decode(data, books, users)) {
+        cout << "Erreur : " << catalogFileName << " est invalide ou endommagé.\n";
+        return false;
+    }
+    for (const Book& book : books) library.addBook(book);
+    for (const User& user : users) library.addUser(user);
+    cout << "Chargé " << books.size() << " livre(s) et " << users.size()
+         << " utilisateur(s) depuis le catalogue compact.\n";
+    return true;
+}
+
+// Write the library in both formats to a temporary folder, then compare the
+// file sizes and the time needed to read them back into books and users
+// (adding them to the library afterwards costs the same for both formats)
+void FileManager::compareStorageFormats(Library& library) {
+    fs::path folder = fs::temp_directory_path() / "bibliotheque_formats";
+    error_code ec;
+    fs::create_directories(folder, ec);
+    string textBooks = (folder / "books.txt").string();
+    string textUsers = (folder / "users.txt").string();
+    string compact = (folder / "catalog.bin").string();
+
+    LibrarySnapshot snapshot = library.snapshot();
+    string data = CompactCatalog::encode(snapshot);
+    bool written = writeBooksFile(snapshot, textBooks) && writeUsersFile(snapshot, textUsers) &&
+                   ofstream(compact, ios::binary).write(data.data(), data.size()).good();
+    if (!written) {
+        cout << "Erreur : Impossible d'écrire dans " << folder.string() << ".\n";
+        fs::remove_all(folder, ec);
+        return;
+    }
+
+    auto millisecondsSince = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    vector<Book> books;
+    vector<User> users;
+
+    auto start = chrono::steady_clock::now();
+    parseBooksFile(textBooks, books);
+    parseUsersFile(textUsers, users);
+    double textTime = millisecondsSince(start);
+
+    books.clear();
+    users.clear();
+    start = chrono::steady_clock::now();
+    string bytes;
+    bool decoded = readCatalogBytes(compact, bytes) && CompactCatalog::decode(bytes, books, users);
+    double compactTime = millisecondsSince(start);
+
+    uintmax_t textSize = fs::file_size(textBooks, ec) + fs::file_size(textUsers, ec);
+    uintmax_t compactSize = fs::file_size(compact, ec);
+    fs::remove_all(folder, ec);
+    if (!decoded) {
+        cout << "Erreur : Le catalogue compact n'a pas pu être relu.\n";
+        return;
+    }
+
+    cout << "Format texte   : " << textSize << " octets, lu en " << textTime << " ms\n";
+    cout << "Format compact : " << compactSize << " octets, lu en " << compactTime << " ms\n";
+    if (compactSize > 0 && compactTime > 0) {
+        cout << "Gain : " << static_cast<double>(textSize) / compactSize << "x plus petit, "
+             << textTime / compactTime << "x plus rapide à lire\n";
+    }
+}
+
+void FileManager::setLazyMode(bool enabled) { lazyMode = enabled; }
+
+// Map books.txt / users.txt and their offset indexes (<file>.idx) without
+// decoding any record
+bool FileManager::openLazyRecords(Library& library) {
+    auto bookRecords = lazyBookRecords(booksFileName);
+    auto userRecords = lazyUserRecords(usersFileName);
+    if (!bookRecords->open()) {
+        return false;
+    }
+    if (!userRecords->open()) {
+        userRecords.reset();
+    }
+
+    cout << "Ouvert " << bookRecords->recordCount() << " livre(s)";
+    if (userRecords) cout << " et " << userRecords->recordCount() << " utilisateur(s)";
+    cout << " en mode paresseux (décodés au premier accès)";
+    if (bookRecords->rebuiltIndex() || (userRecords && userRecords->rebuiltIndex())) {
+        cout << ", index reconstruit";
+    }
+    cout << ".\n";
+
+    library.attachLazyRecords(move(bookRecords), move(userRecords));
+    return true;
+}
+
+// Save in lazy mode without decoding: the records still pending are copied as
+// they are from the mapped files, only the decoded ones are written again.
+// The files are written next to the old ones and renamed at the end, so the
+// mapped versions stay readable (the library keeps using them afterwards).
+bool FileManager::saveLazyCatalog(Library& library) {
+    LibrarySnapshot snapshot = library.decodedSnapshot();
+    string booksTemporary = booksFileName + ".tmp";
+    string usersTemporary = usersFileName + ".tmp";
+
+    bool written = writeBooksFile(snapshot, booksTemporary) && writeUsersFile(snapshot, usersTemporary);
+    if (written) {
+        ofstream books(booksTemporary, ios::app);
+        ofstream users(usersTemporary, ios::app);
+        library.writePendingBooks(books);
+        library.writePendingUsers(users);
+        books.close();
+        users.close();
+        written = !books.fail() && !users.fail();
+    }
+
+    error_code ec;
+    if (written) fs::rename(booksTemporary, booksFileName, ec);
+    if (written && !ec) fs::rename(usersTemporary, usersFileName, ec);
+    if (!written || ec) {
+        cout << "Erreur : Impossible d'écrire " << booksFileName << " et " << usersFileName << ".\n";
+        fs::remove(booksTemporary, ec);
+        fs::remove(usersTemporary, ec);
+        return false;
+    }
+    return saveHoldsToFile(snapshot);
+}
+
+// Stream the books, users or loans of a snapshot to a CSV / JSON Lines file
+bool FileManager::exportRecords(Library& library, CatalogExchange::Kind kind, const string& path) {
+    CatalogExchange::Format format;
+    if (!CatalogExchange::formatFromPath(path, format)) {
+        cout << "Erreur : Extension inconnue (utilisez .csv ou .jsonl).\n";
+        return false;
+    }
+
+    vector<char> buffer(1 << 20); // écriture par blocs de 1 Mo
+    ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    file.open(path, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cout << "Erreur : Impossible d'ouvrir " << path << " en écriture.\n";
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t rows = CatalogExchange::exportTo(library.snapshot(), kind, format, file);
+    file.close();
+    if (!file) {
+        cout << "Erreur : Impossible d'écrire dans " << path << ".\n";
+        return false;
+    }
+    cout << "Exporté " << rows << " ligne(s) vers " << path << " en "
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms.\n";
+    return true;
+}
+
+// Bulk import of books or users; rejected rows go to <file>.erreurs.csv
+bool FileManager::importRecords(Library& library, CatalogExchange::Kind kind, const string& path) {
+    CatalogExchange::Format format;
+    if (!CatalogExchange::formatFromPath(path, format)) {
+        cout << "Erreur : Extension inconnue (utilisez .csv ou .jsonl).\n";
+        return false;
+    }
+
+    string reportPath = path + ".erreurs.csv";
+    ofstream report(reportPath, ios::trunc);
+    if (!report.is_open()) {
+        cout << "Erreur : Impossible d'ouvrir " << reportPath << " en écriture.\n";
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    CatalogExchange::ImportResult result = CatalogExchange::importFrom(library, kind, format, path, report);
+    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    report.close();
+
+    error_code ec;
+    if (result.rejected == 0) fs::remove(reportPath, ec); // rien à signaler
+    if (!result.opened) {
+        cout << "Erreur : Impossible d'ouvrir " << path << ".\n";
+        return false;
+    }
+
+    cout << "Importé " << result.imported << " fiche(s) sur " << result.rows << " ligne(s) en "
+         << elapsed << " ms.\n";
+    if (result.rejected > 0) {
+        cout << result.rejected << " ligne(s) refusée(s), voir " << reportPath << ".\n";
+    }
+    return true;
+}
+
 // Check if file exists
 bool FileManager::fileExists(const string& filename) {
     ifstream file(filename);
     return file.good();
 }
 
-// Create backup
+// Create an incremental backup generation (only new chunks are stored)
 void FileManager::createBackup() {
-    try {
-        if (fileExists(booksFileName)) {
-            filesystem::copy_file(booksFileName, booksFileName + ".backup", filesystem::copy_options::overwrite_existing);
-        }
-        
-        if (fileExists(usersFileName)) {
-            filesystem::copy_file(usersFileName, usersFileName + ".backup", filesystem::copy_options::overwrite_existing);
-        }
-        
-        cout << "Fichiers de sauvegarde créés.\n";
-    } catch (const filesystem::filesystem_error& e) {
-        cerr << "Erreur lors de la création de la sauvegarde : " << e.what() << "\n";
+    BackupStore store(backupDirectory);
+    BackupStore::BackupReport report =
+        store.backup({booksFileName, usersFileName, holdsFileName, eventsFileName, catalogFileName});
+    if (report.generation == 0) {
+        cerr << "Erreur lors de la création de la sauvegarde dans " << backupDirectory << ".\n";
+        return;
     }
+    cout << "Sauvegarde " << report.generation << " créée : " << report.files << " fichier(s), "
+         << report.bytes << " octets en " << report.chunks << " morceau(x).\n";
+    cout << "Nouveaux morceaux : " << report.newChunks << " (" << report.newBytes << " octets écrits).\n";
+}
+
+// List the backup generations, oldest first
+void FileManager::listBackups() {
+    BackupStore store(backupDirectory);
+    vector<BackupStore::Generation> generations = store.listGenerations();
+    if (generations.empty()) {
+        cout << "Aucune sauvegarde dans " << backupDirectory << ".\n";
+        return;
+    }
+    for (const BackupStore::Generation& generation : generations) {
+        uint64_t bytes = 0;
+        for (const auto& file : generation.files) bytes += file.size;
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&generation.created));
+        cout << "  " << generation.number << "  " << date << "  " << generation.files.size()
+             << " fichier(s), " << bytes << " octets\n";
+    }
+}
+
+// Re-read every stored chunk and check its hash
+bool FileManager::verifyBackups() {
+    BackupStore store(backupDirectory);
+    BackupStore::VerifyReport report = store.verify();
+    cout << "Vérifié " << report.chunks << " morceau(x) de " << report.generations << " sauvegarde(s).\n";
+    for (const string& problem : report.problems) cout << "Erreur : " << problem << "\n";
+    if (report.problems.empty()) cout << "Toutes les sauvegardes sont intactes.\n";
+    return report.problems.empty();
+}
+
+// Put the data files back as they were in a backup generation
+bool FileManager::restoreBackup(int generation) {
+    BackupStore store(backupDirectory);
+    BackupStore::Generation saved;
+    string error;
+    if (!store.loadGeneration(generation, saved) ||
+        !store.restore(generation, fs::path(booksFileName).parent_path().string(), error)) {
+        cout << "Erreur : " << (error.empty() ? "sauvegarde introuvable" : error) << ".\n";
+        return false;
+    }
+
+    // fichiers absents de cette sauvegarde : retirés pour garder un ensemble cohérent
+    for (const string& path : {booksFileName, usersFileName, holdsFileName, eventsFileName, catalogFileName}) {
+        string name = fs::path(path).filename().string();
+        bool inBackup = any_of(saved.files.begin(), saved.files.end(),
+                               [&name](const BackupStore::FileEntry& file) { return file.name == name; });
+        error_code ec;
+        if (!inBackup) fs::remove(path, ec);
+    }
+    cout << "Sauvegarde " << generation << " restaurée (" << saved.files.size() << " fichier(s)).\n";
+    return true;
 }
@@ -2,8 +2,11 @@
 #define FILEMANAGER_H
 
 #include <string>
+#include <vector>
 
 #include "library.h"
+#include "shardedlibrary.h"
+#include "catalogexchange.h"
 
 using namespace std;
 
@@ -11,6 +14,21 @@ class FileManager {
 private:
     string booksFileName;
     string usersFileName;
+    string holdsFileName;
+    string eventsFileName;
+    string catalogFileName;
+    string backupDirectory;
+    bool compactMode = false;
+    bool lazyMode = false;
+
+    // Lecture / écriture vers un chemin donné (utilisé aussi par les fragments)
+    bool writeBooksFile(const LibrarySnapshot& snapshot, const string& path);
+    bool writeUsersFile(const LibrarySnapshot& snapshot, const string& path);
+    bool parseBooksFile(const string& path, vector<Book>& books);
+    bool parseUsersFile(const string& path, vector<User>& users);
+    int readBooksFile(Library& library, const string& path);
+    int readUsersFile(Library& library, const string& path);
+    string shardFileName(const string& baseFile, size_t shard) const;
 
 public:
     // Constructor
@@ -20,16 +38,44 @@ public:
     // File operations
     bool saveLibraryData(Library& library);
     bool loadLibraryData(Library& library);
+    bool saveSnapshot(const LibrarySnapshot& snapshot);
     
     // Individual file operations
-    bool saveBooksToFile(Library& library);
-    bool saveUsersToFile(Library& library);
+    bool saveBooksToFile(const LibrarySnapshot& snapshot);
+    bool saveUsersToFile(const LibrarySnapshot& snapshot);
     bool loadBooksFromFile(Library& library);
     bool loadUsersFromFile(Library& library);
+    bool saveHoldsToFile(const LibrarySnapshot& snapshot);
+    bool loadHoldsFromFile(Library& library);
+    bool saveEventLog(Library& library);
+    bool loadEventLog(Library& library);
+    
+    // Compact catalog (catalog.bin): replaces books.txt / users.txt in compact mode
+    void setCompactMode(bool enabled);
+    bool isCompactMode() const;
+    bool saveCompactCatalog(const LibrarySnapshot& snapshot);
+    bool loadCompactCatalog(Library& library);
+    void compareStorageFormats(Library& library);
+    
+    // Lazy mode: map the text files and decode records on first access
+    void setLazyMode(bool enabled);
+    bool openLazyRecords(Library& library);
+    bool saveLazyCatalog(Library& library);
+    
+    // CSV / JSON Lines exchange (format chosen from the file extension)
+    bool exportRecords(Library& library, CatalogExchange::Kind kind, const string& path);
+    bool importRecords(Library& library, CatalogExchange::Kind kind, const string& path);
+    
+    // Sharded library: one file pair per shard, loaded and saved in parallel
+    bool saveShardedLibrary(ShardedLibrary& library);
+    bool loadShardedLibrary(ShardedLibrary& library);
     
     // Utility methods
     bool fileExists(const string& filename);
     void createBackup();
+    void listBackups();
+    bool verifyBackups();
+    bool restoreBackup(int generation);
 };
 
 #endif
@@ -0,0 +1,42 @@
+#include <algorithm>
+
+#include "holdqueue.h"
+#include "memoryusage.h"
+
+using namespace std;
+
+// Add a user at the end of the queue
+void HoldQueue::push(const string& userId) {
+    userIds.push_back(userId);
+}
+
+// Remove and return the next user ("" if the queue is empty)
+string HoldQueue::pop() {
+    if (empty()) return "";
+    string next = move(userIds[head]);
+    head++;
+
+    // récupérer l'espace déjà servi
+    if (head == userIds.size()) {
+        userIds.clear();
+        head = 0;
+    } else if (head * 2 > userIds.size()) {
+        userIds.erase(userIds.begin(), userIds.begin() + head);
+        head = 0;
+    }
+    return next;
+}
+
+bool HoldQueue::contains(const string& userId) const {
+    return find(userIds.begin() + head, userIds.end(), userId) != userIds.end();
+}
+
+bool HoldQueue::empty() const { return head == userIds.size(); }
+
+size_t HoldQueue::size() const { return userIds.size() - head; }
+
+size_t HoldQueue::heapBytes() const { return vectorHeapBytes(userIds); }
+
+vector<string> HoldQueue::getUserIds() const {
+    return vector<string>(userIds.begin() + head, userIds.end());
+}
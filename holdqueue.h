@@ -0,0 +1,27 @@
+#ifndef HOLDQUEUE_H
+#define HOLDQUEUE_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// File d'attente (FIFO) des réservations d'un livre.
+// Un seul vecteur et un indice de tête : retirer le premier est O(1) et
+// l'espace déjà servi est récupéré quand il dépasse la moitié du vecteur.
+class HoldQueue {
+private:
+    vector<string> userIds;
+    size_t head = 0;
+
+public:
+    void push(const string& userId);
+    string pop();
+    bool contains(const string& userId) const;
+    bool empty() const;
+    size_t size() const;
+    size_t heapBytes() const;
+    vector<string> getUserIds() const;
+};
+
+#endif
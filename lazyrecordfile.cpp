@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <fstream>
+#include <filesystem>
+
+#include "lazyrecordfile.h"
+#include "memoryusage.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LAZY_HAVE_MMAP 1
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char INDEX_MAGIC[4] = {'L', 'I', 'X', '2'};
+static const uint32_t NO_FIELD = UINT32_MAX;
+
+// En-tête de <fichier>.idx, suivi des entrées triées par hachage puis des
+// dates du résumé triées
+struct IndexHeader {
+    char magic[4];
+    uint32_t keyField;
+    uint64_t dataSize;   // taille et date du fichier indexé :
+    int64_t dataTime;    // l'index est refait s'il ne correspond plus
+    uint64_t entryCount;
+    uint32_t flagField;  // NO_FIELD : pas de résumé
+    uint32_t dateField;
+    char flagValue[8];
+    uint64_t flaggedCount;
+    uint64_t datedCount;
+};
+
+// Project a whole file in memory (read-only); false if it cannot be mapped
+static bool mapFile(const string& path, void*& mapping, size_t& size) {
+#ifdef LAZY_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // la projection reste valide
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        return false;
+    }
+    return true;
+#else
+    (void)path;
+    (void)mapping;
+    (void)size;
+    return false;
+#endif
+}
+
+static void unmapFile(void*& mapping, size_t& size) {
+#ifdef LAZY_HAVE_MMAP
+    if (mapping) munmap(mapping, size);
+#endif
+    mapping = nullptr;
+    size = 0;
+}
+
+LazyRecordFile::LazyRecordFile(const string& path, size_t keyField)
+    : path(path), indexPath(path + ".idx"), keyField(keyField) {}
+
+LazyRecordFile::LazyRecordFile(const string& path, size_t keyField, const Summary& summary)
+    : path(path), indexPath(path + ".idx"), keyField(keyField), hasSummary(true), summary(summary) {
+    this->summary.flagValue.resize(min<size_t>(summary.flagValue.size(), 7));
+}
+
+LazyRecordFile::~LazyRecordFile() { close(); }
+
+bool LazyRecordFile::open() {
+    error_code ec;
+    if (!fs::exists(path, ec)) return false;
+    int64_t dataTime = static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count());
+
+    if (mapFile(path, mapping, mappingSize)) {
+        data = static_cast<const char*>(mapping);
+        dataSize = mappingSize;
+    } else {
+        // pas de mmap (ou fichier vide) : lecture complète
+        ifstream file(path, ios::binary);
+        if (!file.is_open()) return false;
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data = buffer.data();
+        dataSize = buffer.size();
+    }
+
+    if (!mapIndex(dataTime)) buildIndex(dataTime);
+    return true;
+}
+
+// Use <file>.idx if it still describes the data file
+bool LazyRecordFile::mapIndex(int64_t dataTime) {
+    if (!mapFile(indexPath, indexMapping, indexMappingSize)) return false;
+
+    const IndexHeader* header = static_cast<const IndexHeader*>(indexMapping);
+    char flagValue[8] = {0};
+    if (hasSummary) memcpy(flagValue, summary.flagValue.data(), summary.flagValue.size());
+    bool valid = indexMappingSize >= sizeof(IndexHeader) &&
+                 memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+                 header->keyField == keyField && header->dataSize == dataSize &&
+                 header->dataTime == dataTime &&
+                 header->flagField == (hasSummary ? summary.flagField : NO_FIELD) &&
+                 header->dateField == (hasSummary ? summary.dateField : NO_FIELD) &&
+                 memcmp(header->flagValue, flagValue, sizeof(flagValue)) == 0 &&
+                 header->entryCount <= indexMappingSize / sizeof(IndexEntry) &&
+                 header->datedCount <= indexMappingSize / sizeof(DatedEntry) &&
+                 indexMappingSize == sizeof(IndexHeader) + header->entryCount * sizeof(IndexEntry) +
+                                         header->datedCount * sizeof(DatedEntry);
+    if (!valid) {
+        unmapFile(indexMapping, indexMappingSize);
+        return false;
+    }
+    const char* base = static_cast<const char*>(indexMapping) + sizeof(IndexHeader);
+    entries = reinterpret_cast<const IndexEntry*>(base);
+    entryCount = header->entryCount;
+    dated = reinterpret_cast<const DatedEntry*>(base + entryCount * sizeof(IndexEntry));
+    datedCount = header->datedCount;
+    flaggedCount = header->flaggedCount;
+    return true;
+}
+
+// Scan the data file once, then save the index for the next start
+void LazyRecordFile::buildIndex(int64_t dataTime) {
+    rebuilt = true;
+    builtEntries.clear();
+    builtDated.clear();
+    flaggedCount = 0;
+    for (size_t offset = 0; offset < dataSize;) {
+        size_t end = lineEnd(offset);
+        const char* key;
+        size_t keyLength;
+        if (end > offset && fieldAt(data + offset, end - offset, keyField, key, keyLength)) {
+            builtEntries.push_back({hashKey(key, keyLength), offset});
+
+            const char* field;
+            size_t fieldLength;
+            if (hasSummary && isFlagged(data + offset, end - offset)) {
+                flaggedCount++;
+            } else if (hasSummary && fieldAt(data + offset, end - offset, summary.dateField, field, fieldLength)) {
+                int64_t date = atoll(string(field, fieldLength).c_str());
+                if (date != 0) builtDated.push_back({date, offset});
+            }
+        }
+        offset = end + 1;
+    }
+    sort(builtEntries.begin(), builtEntries.end(), [](const IndexEntry& a, const IndexEntry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.offset < b.offset;
+    });
+    sort(builtDated.begin(), builtDated.end(), [](const DatedEntry& a, const DatedEntry& b) {
+        return a.date != b.date ? a.date < b.date : a.offset < b.offset;
+    });
+    entries = builtEntries.data();
+    entryCount = builtEntries.size();
+    dated = builtDated.data();
+    datedCount = builtDated.size();
+
+    // écrit à côté puis renommé : un index à moitié écrit n'est jamais lu
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.keyField = static_cast<uint32_t>(keyField);
+    header.dataSize = dataSize;
+    header.dataTime = dataTime;
+    header.entryCount = entryCount;
+    header.flagField = hasSummary ? static_cast<uint32_t>(summary.flagField) : NO_FIELD;
+    header.dateField = hasSummary ? static_cast<uint32_t>(summary.dateField) : NO_FIELD;
+    memset(header.flagValue, 0, sizeof(header.flagValue));
+    if (hasSummary) memcpy(header.flagValue, summary.flagValue.data(), summary.flagValue.size());
+    header.flaggedCount = flaggedCount;
+    header.datedCount = datedCount;
+
+    string temporary = indexPath + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(builtEntries.data()), builtEntries.size() * sizeof(IndexEntry));
+    file.write(reinterpret_cast<const char*>(builtDated.data()), builtDated.size() * sizeof(DatedEntry));
+    file.close();
+    error_code ec;
+    if (file) {
+        fs::rename(temporary, indexPath, ec);
+    } else {
+        fs::remove(temporary, ec); // dossier en lecture seule : index en mémoire seulement
+    }
+}
+
+void LazyRecordFile::close() {
+    unmapFile(mapping, mappingSize);
+    unmapFile(indexMapping, indexMappingSize);
+    buffer.clear();
+    buffer.shrink_to_fit();
+    builtEntries.clear();
+    builtEntries.shrink_to_fit();
+    builtDated.clear();
+    builtDated.shrink_to_fit();
+    data = nullptr;
+    dataSize = 0;
+    entries = nullptr;
+    entryCount = 0;
+    dated = nullptr;
+    datedCount = 0;
+}
+
+// FNV-1a (stored in the index file: must not change between versions)
+uint64_t LazyRecordFile::hashKey(const char* key, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(key[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Locate field number `field` of a "a|b|c" line
+bool LazyRecordFile::fieldAt(const char* line, size_t length, size_t field, const char*& start, size_t& fieldLength) {
+    size_t begin = 0;
+    for (size_t i = 0; i < field; ++i) {
+        const void* bar = memchr(line + begin, '|', length - begin);
+        if (!bar) return false;
+        begin = static_cast<const char*>(bar) - line + 1;
+    }
+    const void* bar = memchr(line + begin, '|', length - begin);
+    size_t end = bar ? static_cast<size_t>(static_cast<const char*>(bar) - line) : length;
+    start = line + begin;
+    fieldLength = end - begin;
+    return true;
+}
+
+bool LazyRecordFile::isFlagged(const char* line, size_t length) const {
+    const char* field;
+    size_t fieldLength;
+    return fieldAt(line, length, summary.flagField, field, fieldLength) &&
+           summary.flagValue.compare(0, string::npos, field, fieldLength) == 0;
+}
+
+size_t LazyRecordFile::lineEnd(size_t offset) const {
+    const void* newline = memchr(data + offset, '\n', dataSize - offset);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : dataSize;
+}
+
+bool LazyRecordFile::take(const string& key, string& line) {
+    if (exhausted) return false;
+
+    uint64_t hash = hashKey(key.data(), key.size());
+    const IndexEntry* first = lower_bound(entries, entries + entryCount, hash,
+        [](const IndexEntry& entry, uint64_t value) { return entry.hash < value; });
+
+    for (const IndexEntry* it = first; it != entries + entryCount && it->hash == hash; ++it) {
+        size_t end = lineEnd(it->offset);
+        const char* field;
+        size_t fieldLength;
+        if (!fieldAt(data + it->offset, end - it->offset, keyField, field, fieldLength) ||
+            key.compare(0, string::npos, field, fieldLength) != 0) {
+            continue; // collision de hachage
+        }
+        // déjà remise : la bibliothèque l'a (ou l'a supprimée)
+        if (!taken.insert(it->offset).second) return false;
+        if (hasSummary && isFlagged(data + it->offset, end - it->offset)) flaggedTaken++;
+        line.assign(data + it->offset, end - it->offset);
+        return true;
+    }
+    return false;
+}
+
+void LazyRecordFile::takeAll(const function<void(const string& line)>& consume) {
+    if (exhausted) return;
+
+    string line;
+    for (size_t offset = 0; offset < dataSize;) {
+        size_t end = lineEnd(offset);
+        if (end > offset && !taken.count(offset)) {
+            line.assign(data + offset, end - offset);
+            consume(line);
+        }
+        offset = end + 1;
+    }
+
+    exhausted = true;
+    taken.clear();
+    close();
+}
+
+void LazyRecordFile::copyRemaining(ostream& out) const {
+    if (exhausted) return;
+
+    for (size_t offset = 0; offset < dataSize;) {
+        size_t end = lineEnd(offset);
+        if (end > offset && !taken.count(offset)) {
+            out.write(data + offset, end - offset);
+            out.put('\n');
+        }
+        offset = end + 1;
+    }
+}
+
+size_t LazyRecordFile::flaggedRemaining() const {
+    return exhausted ? 0 : flaggedCount - flaggedTaken;
+}
+
+size_t LazyRecordFile::datedRemainingBefore(int64_t limit) const {
+    if (exhausted) return 0;
+    const DatedEntry* last = lower_bound(dated, dated + datedCount, limit,
+        [](const DatedEntry& entry, int64_t value) { return entry.date < value; });
+    size_t count = 0;
+    for (const DatedEntry* it = dated; it != last; ++it) count += !taken.count(it->offset);
+    return count;
+}
+
+size_t LazyRecordFile::recordCount() const { return entryCount; }
+size_t LazyRecordFile::remaining() const { return exhausted ? 0 : entryCount - taken.size(); }
+bool LazyRecordFile::rebuiltIndex() const { return rebuilt; }
+
+size_t LazyRecordFile::heapBytes() const {
+    return stringHeapBytes(buffer) + vectorHeapBytes(builtEntries) + vectorHeapBytes(builtDated) +
+           hashTableHeapBytes(taken);
+}
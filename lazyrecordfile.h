@@ -0,0 +1,113 @@
+#ifndef LAZYRECORDFILE_H
+#define LAZYRECORDFILE_H
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_set>
+
+using namespace std;
+
+// Fichier texte d'enregistrements (une ligne "champ|champ|..." par
+// enregistrement) ouvert sans être lu : le fichier est projeté en mémoire
+// (mmap) et un index trié (hachage de la clé -> position de la ligne) est
+// gardé à côté dans <fichier>.idx. Tant que l'index est à jour, l'ouverture
+// ne dépend pas de la taille du fichier ; sinon il est reconstruit une fois.
+// Chaque ligne n'est remise qu'une seule fois (recherche par clé ou parcours
+// de toutes les lignes restantes) : la bibliothèque garde ensuite l'objet.
+class LazyRecordFile {
+public:
+    // Résumé gardé dans l'index, pour les statistiques sans décoder les lignes :
+    //  - le nombre de lignes dont le champ flagField vaut flagValue ;
+    //  - pour les autres lignes, la date (entier, 0 = inconnue) du champ
+    //    dateField, triée : ex. disponibilité et date de retour d'un livre.
+    struct Summary {
+        size_t flagField;
+        string flagValue;   // 7 caractères au plus
+        size_t dateField;
+    };
+
+    // keyField : numéro du champ qui sert de clé (ex. 2 pour l'ISBN d'un livre)
+    LazyRecordFile(const string& path, size_t keyField);
+    LazyRecordFile(const string& path, size_t keyField, const Summary& summary);
+    ~LazyRecordFile();
+
+    LazyRecordFile(const LazyRecordFile&) = delete;
+    LazyRecordFile& operator=(const LazyRecordFile&) = delete;
+
+    // Projette le fichier et charge (ou reconstruit) l'index
+    bool open();
+
+    // Remet la ligne de cette clé, si elle existe et n'a pas déjà été remise
+    bool take(const string& key, string& line);
+
+    // Remet toutes les lignes restantes, dans l'ordre du fichier, puis ferme le fichier
+    void takeAll(const function<void(const string& line)>& consume);
+
+    // Recopie les lignes restantes telles quelles, sans les remettre (sauvegarde)
+    void copyRemaining(ostream& out) const;
+
+    // Lignes restantes marquées (flagField == flagValue), sans lire le fichier
+    size_t flaggedRemaining() const;
+    // Lignes restantes non marquées dont la date est connue et < limit : O(k)
+    size_t datedRemainingBefore(int64_t limit) const;
+
+    size_t recordCount() const;
+    size_t remaining() const;
+    size_t heapBytes() const; // sans les pages projetées (cache du système)
+    bool rebuiltIndex() const;
+
+private:
+    struct IndexEntry {
+        uint64_t hash;
+        uint64_t offset;
+    };
+
+    struct DatedEntry {
+        int64_t date;
+        uint64_t offset;
+    };
+
+    string path;
+    string indexPath;
+    size_t keyField;
+    bool hasSummary = false;
+    Summary summary{};
+
+    // données : projetées, ou lues en entier sans mmap
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+    string buffer;
+
+    // index : projeté, ou reconstruit en mémoire
+    const IndexEntry* entries = nullptr;
+    size_t entryCount = 0;
+    void* indexMapping = nullptr;
+    size_t indexMappingSize = 0;
+    vector<IndexEntry> builtEntries;
+    bool rebuilt = false;
+
+    // résumé : projeté avec l'index, ou reconstruit
+    size_t flaggedCount = 0;
+    const DatedEntry* dated = nullptr;
+    size_t datedCount = 0;
+    vector<DatedEntry> builtDated;
+
+    unordered_set<uint64_t> taken;  // positions déjà remises
+    size_t flaggedTaken = 0;
+    bool exhausted = false;
+
+    static uint64_t hashKey(const char* key, size_t length);
+    static bool fieldAt(const char* line, size_t length, size_t field, const char*& start, size_t& fieldLength);
+    size_t lineEnd(size_t offset) const;
+    bool isFlagged(const char* line, size_t length) const;
+    bool mapIndex(int64_t dataTime);
+    void buildIndex(int64_t dataTime);
+    void close();
+};
+
+#endif
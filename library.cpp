@@ -2,47 +2,193 @@
 #include <algorithm>
 
 #include "library.h"
+#include "threadpool.h"
+#include "mergesorted.h"
+#include "radixsort.h"
 
 using namespace std;
 
 // Constructor
 Library::Library() {}
 
+// Sort orders shared by the listings (and by the sharded merge):
+// French collation keys computed once per book / user (see collation.h)
+bool Library::compareByTitle(const Book* a, const Book* b) {
+    return a->getTitleKey() < b->getTitleKey();
+}
+
+bool Library::compareByAuthor(const Book* a, const Book* b) {
+    return a->getAuthorKey() < b->getAuthorKey();
+}
+
+bool Library::compareByTitleThenAuthor(const Book* a, const Book* b) {
+    int byTitle = a->getTitleKey().compare(b->getTitleKey());
+    if (byTitle == 0)
+        return a->getAuthorKey() < b->getAuthorKey();
+    return byTitle < 0;
+}
+
+bool Library::compareUsersByName(const User* a, const User* b) {
+    return a->getNameKey() < b->getNameKey();
+}
+
+// Clés pour le tri par base, dans le même ordre que les comparateurs
+static const string& titleThenAuthorKey(const Book* book, size_t field) {
+    return field == 0 ? book->getTitleKey() : book->getAuthorKey();
+}
+
+static const string& titleKey(const Book* book, size_t) { return book->getTitleKey(); }
+static const string& authorKey(const Book* book, size_t) { return book->getAuthorKey(); }
+static const string& userNameKey(const User* user, size_t) { return user->getNameKey(); }
+
 // Add book to library
 void Library::addBook(const Book& book) {
-    books.push_back(make_unique<Book>(book));
+    generation++;
+    auto record = make_shared<Book>(book);
+    // prêt déjà en cours (chargement depuis le fichier)
+    if (!book.getAvailability() && book.getDueDate() != 0) {
+        record->setLoanSequence(++lastLoanSequence);
+        dueDates.push(book.getDueDate(), book.getISBN(), lastLoanSequence);
+    }
+    books.push_back(move(record));
+    slotByIsbn.emplace(book.getISBN(), books.size() - 1);
+    if (!indexDirty) {
+        index.addBook(books.size() - 1, *books.back());
+    }
+}
+
+// Add a batch of books (bulk import): one new generation for the whole
+// batch, and the bitmap index is rebuilt once on the next query
+void Library::addBooks(vector<Book> batch) {
+    if (batch.empty()) return;
+    generation++;
+    // place doublée : les lots suivants ne refont pas toute la table
+    if (slotByIsbn.size() + batch.size() > slotByIsbn.bucket_count()) {
+        slotByIsbn.reserve(2 * (slotByIsbn.size() + batch.size()));
+    }
+    for (Book& book : batch) {
+        if (!book.getAvailability() && book.getDueDate() != 0) {
+            book.setLoanSequence(++lastLoanSequence);
+            dueDates.push(book.getDueDate(), book.getISBN(), lastLoanSequence);
+        }
+        slotByIsbn.emplace(book.getISBN(), books.size());
+        books.push_back(make_shared<Book>(move(book)));
+    }
+    indexDirty = true;
 }
 
 // Remove book from library
 bool Library::removeBook(const string& isbn) {
-    auto it = find_if(books.begin(), books.end(),
-        [&isbn](const unique_ptr<Book>& book) {
-            return book->getISBN() == isbn;
-        });
-    
-    if (it != books.end()) {
-        books.erase(it);
-        return true;
+    size_t slot = loadBookSlot(isbn);
+    if (slot == books.size()) return false;
+
+    generation++;
+    if (!books[slot]->getAvailability()) dueDates.markStale();
+    holdQueues.erase(isbn);
+
+    // le dernier livre prend la place libérée : seule sa position change
+    size_t last = books.size() - 1;
+    if (!indexDirty) {
+        index.removeBook(static_cast<uint32_t>(slot), *books[slot]);
+        if (slot != last) {
+            index.removeBook(static_cast<uint32_t>(last), *books[last]);
+            index.addBook(static_cast<uint32_t>(slot), *books[last]);
+        }
     }
-    return false;
+    slotByIsbn.erase(isbn);
+    if (slot != last) {
+        auto moved = slotByIsbn.emplace(books[last]->getISBN(), slot).first;
+        if (moved->second == last) moved->second = slot;
+    }
+    books.erase(slot);
+    return true;
+}
+
+// Position of a book in the vector (books.size() if not found)
+size_t Library::findBookSlot(const string& isbn) const {
+    auto it = slotByIsbn.find(isbn);
+    return (it != slotByIsbn.end()) ? it->second : books.size();
+}
+
+// Position of a book, decoding it from the lazy file on first access
+size_t Library::loadBookSlot(const string& isbn) {
+    size_t slot = findBookSlot(isbn);
+    string line;
+    if (slot == books.size() && lazyBooks && lazyBooks->take(isbn, line)) {
+        Book book;
+        book.fromFileFormat(line);
+        addBook(book);
+        slot = findBookSlot(isbn);
+        if (lazyBooks->remaining() == 0) lazyBooks.reset(); // tout est décodé
+    }
+    return slot;
+}
+
+// Decode every book still in the lazy file (before a scan of the catalog)
+void Library::loadAllBooks() {
+    if (!lazyBooks) return;
+    lazyBooks->takeAll([this](const string& line) {
+        Book book;
+        book.fromFileFormat(line);
+        addBook(book);
+    });
+    lazyBooks.reset();
+}
+
+void Library::loadAllUsers() {
+    if (!lazyUsers) return;
+    lazyUsers->takeAll([this](const string& line) {
+        User user;
+        user.fromFileFormat(line);
+        addUser(user);
+    });
+    lazyUsers.reset();
+}
+
+void Library::attachLazyRecords(unique_ptr<LazyRecordFile> bookRecords, unique_ptr<LazyRecordFile> userRecords) {
+    lazyBooks = move(bookRecords);
+    lazyUsers = move(userRecords);
+    generation++;
+}
+
+// Records not decoded yet
+size_t Library::getPendingRecordCount() const {
+    return (lazyBooks ? lazyBooks->remaining() : 0) + (lazyUsers ? lazyUsers->remaining() : 0);
+}
+
+// Lines of the records not decoded yet, as read from the files
+void Library::writePendingBooks(ostream& out) const {
+    if (lazyBooks) lazyBooks->copyRemaining(out);
+}
+
+void Library::writePendingUsers(ostream& out) const {
+    if (lazyUsers) lazyUsers->copyRemaining(out);
 }
 
 // Find book by ISBN
 Book* Library::findBookByISBN(const string& isbn) {
-    auto it = find_if(books.begin(), books.end(),
-        [&isbn](const unique_ptr<Book>& book) {
-            return book->getISBN() == isbn;
-        });
-    
-    return (it != books.end()) ? it->get() : nullptr;
+    size_t slot = loadBookSlot(isbn);
+    return (slot < books.size()) ? books[slot].get() : nullptr;
 }
 
 // Search books by title (case-insensitive partial match)
 // Ajout du tri par titre pour un affichage plus organisé
 vector<Book*> Library::searchBooksByTitle(const string& title) {
+    loadAllBooks();
+    string key = cacheKey("title", title);
+    vector<Book*> cached;
+    if (bookCache.get(key, generation, cached)) return cached;
+
     vector<Book*> results;
     string lowerTitle = title;
     transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), ::tolower);
+
+    // grand catalogue : balayage en parallèle
+    if (books.size() >= PARALLEL_SEARCH_THRESHOLD) {
+        results = parallelSearch(lowerTitle, &Book::getTitle, &Book::getTitleKey);
+        bookCache.put(key, generation, results);
+        return results;
+    }
     
     for (auto& book : books) {
         string bookTitle = book->getTitle();
@@ -54,19 +200,30 @@ vector<Book*> Library::searchBooksByTitle(const string& title) {
     }
 
     // 🔹 Tri des résultats par ordre alphabétique du titre
-    sort(results.begin(), results.end(), [](Book* a, Book* b) {
-        return a->getTitle() < b->getTitle();
-    });
+    msdRadixSort(results.begin(), results.end(), titleKey);
 
+    bookCache.put(key, generation, results);
     return results;
 }
 
 // Search books by author (case-insensitive partial match)
 // Ajout du tri par auteur pour une recherche plus claire
 vector<Book*> Library::searchBooksByAuthor(const string& author) {
+    loadAllBooks();
+    string key = cacheKey("author", author);
+    vector<Book*> cached;
+    if (bookCache.get(key, generation, cached)) return cached;
+
     vector<Book*> results;
     string lowerAuthor = author;
     transform(lowerAuthor.begin(), lowerAuthor.end(), lowerAuthor.begin(), ::tolower);
+
+    // grand catalogue : balayage en parallèle
+    if (books.size() >= PARALLEL_SEARCH_THRESHOLD) {
+        results = parallelSearch(lowerAuthor, &Book::getAuthor, &Book::getAuthorKey);
+        bookCache.put(key, generation, results);
+        return results;
+    }
     
     for (auto& book : books) {
         string bookAuthor = book->getAuthor();
@@ -78,16 +235,61 @@ vector<Book*> Library::searchBooksByAuthor(const string& author) {
     }
 
     // 🔹 Tri des résultats par ordre alphabétique de l’auteur
-    sort(results.begin(), results.end(), [](Book* a, Book* b) {
-        return a->getAuthor() < b->getAuthor();
-    });
+    msdRadixSort(results.begin(), results.end(), authorKey);
+
+    bookCache.put(key, generation, results);
+    return results;
+}
 
+// Parallel substring search: the catalog is split into chunks scanned by
+// the shared work-stealing pool; each chunk sorts its own matches and the
+// sorted chunks are then merged
+vector<Book*> Library::parallelSearch(const string& lowerText, string (Book::*field)() const,
+                                      const string& (Book::*sortKey)() const) {
+    ThreadPool& pool = ThreadPool::shared();
+    size_t chunkCount = min(books.size(), pool.size() * 8);
+    size_t chunkSize = (books.size() + chunkCount - 1) / chunkCount;
+
+    vector<vector<Book*>> partials(chunkCount);
+    vector<function<void()>> tasks;
+    for (size_t c = 0; c < chunkCount; ++c) {
+        tasks.push_back([this, c, chunkSize, &partials, &lowerText, field, sortKey]() {
+            size_t begin = c * chunkSize;
+            size_t end = min(books.size(), begin + chunkSize);
+            string value; // réutilisé d'un livre à l'autre
+            for (size_t i = begin; i < end; ++i) {
+                value = ((*books[i]).*field)();
+                transform(value.begin(), value.end(), value.begin(), ::tolower);
+                if (value.find(lowerText) != string::npos) {
+                    partials[c].push_back(books[i].get());
+                }
+            }
+            msdRadixSort(partials[c].begin(), partials[c].end(),
+                         [sortKey](const Book* book, size_t) -> const string& { return (book->*sortKey)(); });
+        });
+    }
+    pool.runAll(tasks);
+
+    vector<Book*> results;
+    vector<size_t> bounds = {0};
+    for (const auto& partial : partials) {
+        results.insert(results.end(), partial.begin(), partial.end());
+        bounds.push_back(results.size());
+    }
+    mergeSortedRuns(results, bounds, [sortKey](const Book* a, const Book* b) {
+        return (a->*sortKey)() < (b->*sortKey)();
+    }, &pool);
     return results;
 }
 
 // Get all available books
 // Ajout du tri par titre/auteur pour un affichage propre
 vector<Book*> Library::getAvailableBooks() {
+    loadAllBooks();
+    string key = cacheKey("available", "");
+    vector<Book*> cached;
+    if (bookCache.get(key, generation, cached)) return cached;
+
     vector<Book*> available;
     for (auto& book : books) {
         if (book->getAvailability()) {
@@ -96,95 +298,341 @@ vector<Book*> Library::getAvailableBooks() {
     }
 
     // 🔹 Tri des livres disponibles par titre puis par auteur
-    sort(available.begin(), available.end(), [](Book* a, Book* b) {
-        if (a->getTitle() == b->getTitle())
-            return a->getAuthor() < b->getAuthor();
-        return a->getTitle() < b->getTitle();
-    });
+    msdRadixSort(available.begin(), available.end(), titleThenAuthorKey, 2);
 
+    bookCache.put(key, generation, available);
     return available;
 }
 
 // Get all books
 // Ajout du tri global pour toujours afficher les livres dans un ordre logique
 vector<Book*> Library::getAllBooks() {
+    loadAllBooks();
+    string key = cacheKey("all", "");
+    vector<Book*> cached;
+    if (bookCache.get(key, generation, cached)) return cached;
+
     vector<Book*> allBooks;
     for (auto& book : books) {
         allBooks.push_back(book.get());
     }
 
     // 🔹 Tri de tous les livres par titre puis auteur
-    sort(allBooks.begin(), allBooks.end(), [](Book* a, Book* b) {
-        if (a->getTitle() == b->getTitle())
-            return a->getAuthor() < b->getAuthor();
-        return a->getTitle() < b->getTitle();
-    });
+    msdRadixSort(allBooks.begin(), allBooks.end(), titleThenAuthorKey, 2);
 
+    bookCache.put(key, generation, allBooks);
     return allBooks;
 }
 
+// Cache key: query type + normalized text (lowercase, like the searches)
+string Library::cacheKey(const string& type, const string& text) {
+    string key = type + '\x1f' + text;
+    transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return key;
+}
+
+void Library::setCacheCapacity(size_t capacity) {
+    bookCache.setCapacity(capacity);
+    userCache.setCapacity(capacity);
+}
+
+size_t Library::getCacheCapacity() const { return bookCache.getCapacity(); }
+size_t Library::getCacheHits() const { return bookCache.getHits() + userCache.getHits(); }
+size_t Library::getCacheMisses() const { return bookCache.getMisses() + userCache.getMisses(); }
+size_t Library::getCacheSize() const { return bookCache.size() + userCache.size(); }
+
+// Rebuild the bitmap index after a bulk import
+void Library::ensureIndex() {
+    if (indexDirty) {
+        index.rebuild(books);
+        indexDirty = false;
+    }
+}
+
+// Combined query (title / author / availability) answered from the bitmap index
+vector<Book*> Library::query(const BookQuery& bookQuery) {
+    loadAllBooks();
+    ensureIndex();
+    vector<Book*> results;
+    index.evaluate(bookQuery, books).forEach([this, &results](uint32_t id) {
+        results.push_back(books[id].get());
+    });
+
+    // Même ordre que les listes : titre puis auteur
+    msdRadixSort(results.begin(), results.end(), titleThenAuthorKey, 2);
+
+    return results;
+}
+
 // Add user to library
 void Library::addUser(const User& user) {
-    users.push_back(make_unique<User>(user));
+    generation++;
+    users.push_back(make_shared<User>(user));
+    userSlotById.emplace(user.getUserId(), users.size() - 1);
+}
+
+// Add a batch of users (bulk import)
+void Library::addUsers(vector<User> batch) {
+    if (batch.empty()) return;
+    generation++;
+    if (userSlotById.size() + batch.size() > userSlotById.bucket_count()) {
+        userSlotById.reserve(2 * (userSlotById.size() + batch.size()));
+    }
+    for (User& user : batch) {
+        userSlotById.emplace(user.getUserId(), users.size());
+        users.push_back(make_shared<User>(move(user)));
+    }
 }
 
 // Find user by ID
 User* Library::findUserById(const string& userId) {
-    auto it = find_if(users.begin(), users.end(),
-        [&userId](const unique_ptr<User>& user) {
-            return user->getUserId() == userId;
-        });
-    
-    return (it != users.end()) ? it->get() : nullptr;
+    auto it = userSlotById.find(userId);
+    string line;
+    if (it == userSlotById.end() && lazyUsers && lazyUsers->take(userId, line)) {
+        User user;
+        user.fromFileFormat(line);
+        addUser(user);
+        it = userSlotById.find(userId);
+        if (lazyUsers->remaining() == 0) lazyUsers.reset();
+    }
+    return (it != userSlotById.end()) ? users[it->second].get() : nullptr;
+}
+
+// Library that keeps this user: this one first, then the owner (users kept elsewhere)
+Library& Library::userLibrary(const string& userId) {
+    if (userOwner && !userId.empty() && !findUserById(userId)) {
+        Library* owner = userOwner(userId);
+        if (owner) return *owner;
+    }
+    return *this;
+}
+
+// User wherever it is kept; read only (changes go through borrowFor / returnFor)
+const User* Library::resolveUser(const string& userId) {
+    return userLibrary(userId).findUserById(userId);
+}
+
+// User ready to be modified: a private copy if a snapshot still shares it
+User* Library::editUser(const string& userId) {
+    User* shared = findUserById(userId);
+    if (!shared) return nullptr;
+    User* user = &users.edit(userSlotById.at(userId));
+    // copié : les résultats en cache pointent encore vers la fiche de l'instantané
+    if (user != shared) generation++;
+    return user;
+}
+
+void Library::setUserOwner(function<Library*(const string&)> owner) {
+    userOwner = move(owner);
+}
+
+bool Library::borrowFor(const string& userId, const string& isbn) {
+    User* user = editUser(userId);
+    if (!user) return false;
+    generation++;
+    user->borrowBook(isbn);
+    return true;
+}
+
+bool Library::returnFor(const string& userId, const string& isbn) {
+    User* user = editUser(userId);
+    if (!user) return false;
+    generation++;
+    user->returnBook(isbn);
+    return true;
 }
 
 // Get all users
 // Ajout du tri alphabetique des utilisateurs par nom
 vector<User*> Library::getAllUsers() {
+    loadAllUsers();
+    string key = cacheKey("users", "");
+    vector<User*> cached;
+    if (userCache.get(key, generation, cached)) return cached;
+
     vector<User*> allUsers;
     for (auto& user : users) {
         allUsers.push_back(user.get());
     }
 
     // Tri des users par ordre alphabétique du nom
-    sort(allUsers.begin(), allUsers.end(), [](User* a, User* b) {
-        return a->getName() < b->getName();
-    });
+    msdRadixSort(allUsers.begin(), allUsers.end(), userNameKey);
 
+    userCache.put(key, generation, allUsers);
     return allUsers;
 }
 
 // Check out book
 bool Library::checkOutBook(const string& isbn, const string& userId) {
-    Book* book = findBookByISBN(isbn);
-    User* user = findUserById(userId);
+    size_t slot = loadBookSlot(isbn);
+    Book* book = (slot < books.size()) ? books[slot].get() : nullptr;
+    const User* user = resolveUser(userId);
     
     if (book && user && book->getAvailability()) {
-        book->checkOut(user->getName());
-        user->borrowBook(isbn);
+        lendBook(slot, *user);
         return true;
     }
     return false;
 }
 
+// Record a loan of the book at this position to the user (kept here or elsewhere)
+void Library::lendBook(size_t slot, const User& user) {
+    generation++;
+    string userId = user.getUserId();
+    Book* book = &books.edit(slot);
+    time_t now = time(nullptr);
+    time_t due = now + LOAN_DURATION_DAYS * 24 * 60 * 60;
+    book->checkOut(user.getName(), userId, now, due);
+    book->setLoanSequence(++lastLoanSequence);
+    userLibrary(userId).borrowFor(userId, book->getISBN());
+    dueDates.push(due, book->getISBN(), lastLoanSequence);
+    events.record(now, book->getISBN(), userId, EventLog::Action::CHECKOUT);
+    if (!indexDirty) index.setAvailability(slot, book->getAvailability());
+}
+
+// Give a returned book to the first holder still registered (nullptr if none)
+const User* Library::handOffToNextHolder(size_t slot) {
+    auto it = holdQueues.find(books[slot]->getISBN());
+    if (it == holdQueues.end()) return nullptr;
+
+    const User* next = nullptr;
+    while (!next && !it->second.empty()) {
+        next = resolveUser(it->second.pop());
+    }
+    if (it->second.empty()) holdQueues.erase(it);
+
+    if (next) lendBook(slot, *next);
+    return next;
+}
+
 // Return book
 bool Library::returnBook(const string& isbn) {
-    Book* book = findBookByISBN(isbn);
+    size_t slot = loadBookSlot(isbn);
+    Book* book = (slot < books.size()) ? books[slot].get() : nullptr;
     
     if (book && !book->getAvailability()) {
-        // Find the user who borrowed this book
-        for (auto& user : users) {
-            if (user->hasBorrowedBook(isbn)) {
-                user->returnBook(isbn);
-                break;
+        // Find the user who borrowed this book (by id, or by scanning for older loans)
+        string borrowerId = book->getBorrowerId();
+        const User* borrower = resolveUser(borrowerId);
+        if (borrower && borrower->hasBorrowedBook(isbn)) {
+            userLibrary(borrowerId).returnFor(borrowerId, isbn);
+        } else {
+            loadAllUsers();
+            for (size_t i = 0; i < users.size(); ++i) {
+                if (users[i]->hasBorrowedBook(isbn)) {
+                    borrowerId = users[i]->getUserId();
+                    returnFor(borrowerId, isbn);
+                    break;
+                }
             }
         }
+        generation++;
+        events.record(time(nullptr), isbn, borrowerId, EventLog::Action::RETURN);
+        book = &books.edit(slot);
         book->returnBook();
+        if (!indexDirty) index.setAvailability(slot, book->getAvailability());
+        dueDates.markStale();
+        dueDates.compactIfNeeded([this](const DueDateTracker::Entry& e) { return isCurrentLoan(e); });
+
+        // le livre passe directement au prochain dans la file de réservation
+        handOffToNextHolder(slot);
         return true;
     }
     return false;
 }
 
+// Place a hold on a checked-out book
+bool Library::placeHold(const string& isbn, const string& userId) {
+    Book* book = findBookByISBN(isbn);
+    const User* user = resolveUser(userId);
+    if (!book || !user || book->getAvailability()) return false;
+    if (book->getBorrowerId() == userId || user->hasBorrowedBook(isbn)) return false;
+
+    HoldQueue& queue = holdQueues[isbn];
+    if (queue.contains(userId)) return false;
+    queue.push(userId);
+    return true;
+}
+
+// Append a hold without checks (used when loading the holds file)
+void Library::enqueueHold(const string& isbn, const string& userId) {
+    holdQueues[isbn].push(userId);
+}
+
+size_t Library::getHoldQueueDepth(const string& isbn) const {
+    auto it = holdQueues.find(isbn);
+    return (it != holdQueues.end()) ? it->second.size() : 0;
+}
+
+size_t Library::getTotalHolds() const {
+    size_t total = 0;
+    for (const auto& entry : holdQueues) total += entry.second.size();
+    return total;
+}
+
+// All non-empty queues, sorted by ISBN
+vector<pair<string, vector<string>>> Library::getAllHolds() const {
+    vector<pair<string, vector<string>>> holds;
+    for (const auto& entry : holdQueues) {
+        if (!entry.second.empty()) holds.emplace_back(entry.first, entry.second.getUserIds());
+    }
+    sort(holds.begin(), holds.end());
+    return holds;
+}
+
+EventLog& Library::getEventLog() { return events; }
+
+// A heap entry is still current if it belongs to the book's ongoing loan
+// (a return and a new loan within the same second give the same due date)
+bool Library::isCurrentLoan(const DueDateTracker::Entry& entry) const {
+    size_t slot = findBookSlot(entry.isbn);
+    if (slot >= books.size()) return false;
+    const Book& book = *books[slot];
+    return !book.getAvailability() && book.getLoanSequence() == entry.loanSequence &&
+           book.getDueDate() == entry.dueDate;
+}
+
+// Overdue loans, oldest due date first
+vector<Book*> Library::getOverdueBooks(time_t now) {
+    loadAllBooks(); // les échéances ne sont connues que des livres décodés
+    vector<Book*> overdue;
+    auto entries = dueDates.overdue(now, [this](const DueDateTracker::Entry& e) { return isCurrentLoan(e); });
+    for (const auto& entry : entries) {
+        overdue.push_back(books[findBookSlot(entry.isbn)].get());
+    }
+    return overdue;
+}
+
+// Overdue loans among decoded books, plus those listed in the lazy index
+int Library::getOverdueCount(time_t now) const {
+    size_t decoded = dueDates.overdue(now, [this](const DueDateTracker::Entry& e) { return isCurrentLoan(e); }).size();
+    size_t pending = lazyBooks ? lazyBooks->datedRemainingBefore(static_cast<int64_t>(now)) : 0;
+    return static_cast<int>(decoded + pending);
+}
+
+// Next loans to come back, soonest first
+vector<Book*> Library::getNextDueBooks(size_t count) {
+    loadAllBooks();
+    vector<Book*> next;
+    auto entries = dueDates.nextDue(count, [this](const DueDateTracker::Entry& e) { return isCurrentLoan(e); });
+    for (const auto& entry : entries) {
+        next.push_back(books[findBookSlot(entry.isbn)].get());
+    }
+    return next;
+}
+
+// Point-in-time view sharing the records (nothing is copied until a
+// later write touches them)
+LibrarySnapshot Library::snapshot() {
+    loadAllBooks();
+    loadAllUsers();
+    return decodedSnapshot();
+}
+
+LibrarySnapshot Library::decodedSnapshot() const {
+    return LibrarySnapshot(books, users, getAllHolds(), generation);
+}
+
 // Display all books
 void Library::displayAllBooks() {
     auto allBooks = getAllBooks(); // maintenant déjà triés
@@ -237,11 +685,57 @@ void Library::displayAllUsers() {
 }
 
 // Statistics
-int Library::getTotalBooks() const { return books.size(); }
+int Library::getTotalBooks() const {
+    return books.size() + (lazyBooks ? lazyBooks->remaining() : 0);
+}
+int Library::getTotalUsers() const {
+    return users.size() + (lazyUsers ? lazyUsers->remaining() : 0);
+}
 int Library::getAvailableBookCount() const {
-    return count_if(books.begin(), books.end(),
-        [](const unique_ptr<Book>& book) {
+    // livres pas encore décodés : compte gardé dans l'index du fichier
+    size_t pending = lazyBooks ? lazyBooks->flaggedRemaining() : 0;
+    return pending + count_if(books.begin(), books.end(),
+        [](const shared_ptr<Book>& book) {
             return book->getAvailability();
         });
 }
 int Library::getCheckedOutBookCount() const { return getTotalBooks() - getAvailableBookCount(); }
+
+// Memory accounting, one line per structure
+vector<pair<string, size_t>> Library::memoryReport() const {
+    size_t bookObjects = books.size() * sizeof(Book);
+    size_t bookText = 0;
+    for (const auto& book : books) bookText += book->heapBytes();
+
+    size_t userObjects = users.size() * sizeof(User);
+    size_t userText = 0, borrowed = 0;
+    for (const auto& user : users) {
+        userText += user->heapBytes();
+        borrowed += user->borrowedBooksBytes();
+    }
+
+    size_t keyIndexes = hashTableHeapBytes(slotByIsbn) + hashTableHeapBytes(userSlotById);
+    for (const auto& entry : slotByIsbn) keyIndexes += stringHeapBytes(entry.first);
+    for (const auto& entry : userSlotById) keyIndexes += stringHeapBytes(entry.first);
+
+    size_t holds = hashTableHeapBytes(holdQueues);
+    for (const auto& entry : holdQueues) holds += stringHeapBytes(entry.first) + entry.second.heapBytes();
+
+    size_t lazyIndexes = (lazyBooks ? lazyBooks->heapBytes() : 0) + (lazyUsers ? lazyUsers->heapBytes() : 0);
+
+    return {
+        {"Livres : fiches", bookObjects},
+        {"Livres : texte (tas)", bookText},
+        {"Utilisateurs : fiches", userObjects},
+        {"Utilisateurs : texte (tas)", userText},
+        {"Utilisateurs : listes d'emprunts", borrowed},
+        {"Vecteurs de pointeurs", books.heapBytes() + users.heapBytes()},
+        {"Index ISBN / ID", keyIndexes},
+        {"Index en bitmaps", index.heapBytes()},
+        {"Échéances", dueDates.heapBytes()},
+        {"Réservations", holds},
+        {"Historique des emprunts", events.heapBytes()},
+        {"Cache des recherches", bookCache.heapBytes() + userCache.heapBytes()},
+        {"Mode paresseux : index", lazyIndexes},
+    };
+}
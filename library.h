@@ -3,49 +3,166 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
+#include <ctime>
+#include <functional>
 
 #include "book.h"
 #include "user.h"
+#include "bookindex.h"
+#include "duedatetracker.h"
+#include "holdqueue.h"
+#include "eventlog.h"
+#include "querycache.h"
+#include "lazyrecordfile.h"
+#include "cowvector.h"
+#include "librarysnapshot.h"
 
 using namespace std;
 
 class Library {
 private:
-    vector<unique_ptr<Book>> books;
-    vector<unique_ptr<User>> users;
+    // Partagés avec les instantanés : toute modification passe par edit()
+    CowVector<Book> books;
+    CowVector<User> users;
+
+    // Index en bitmaps pour les requêtes combinées (reconstruit après un ajout par lots)
+    BookIndex index;
+    bool indexDirty = false;
+
+    // Position de chaque livre par ISBN
+    unordered_map<string, size_t> slotByIsbn;
+
+    // Position de chaque utilisateur par ID
+    unordered_map<string, size_t> userSlotById;
+
+    // Échéances des prêts en cours ; chaque prêt reçoit un numéro unique
+    DueDateTracker dueDates;
+    uint64_t lastLoanSequence = 0;
+
+    // Files de réservation par ISBN
+    unordered_map<string, HoldQueue> holdQueues;
+
+    // Historique des emprunts et retours
+    EventLog events;
+
+    // Résultats récents des recherches et listes, invalidés par la génération
+    uint64_t generation = 0;
+    QueryCache<vector<Book*>> bookCache;
+    QueryCache<vector<User*>> userCache;
+
+    // Bibliothèque qui gère les utilisateurs absents d'ici (bibliothèque
+    // fragmentée) : on y lit l'utilisateur, et on lui demande de le modifier
+    function<Library*(const string&)> userOwner;
+
+    // Mode paresseux : fiches encore dans les fichiers, décodées au premier accès
+    unique_ptr<LazyRecordFile> lazyBooks;
+    unique_ptr<LazyRecordFile> lazyUsers;
+
+    void ensureIndex();
+    static string cacheKey(const string& type, const string& text);
+    size_t findBookSlot(const string& isbn) const;
+    size_t loadBookSlot(const string& isbn);
+    void loadAllBooks();
+    void loadAllUsers();
+    bool isCurrentLoan(const DueDateTracker::Entry& entry) const;
+    void lendBook(size_t slot, const User& user);
+    const User* handOffToNextHolder(size_t slot);
+    Library& userLibrary(const string& userId);
+    const User* resolveUser(const string& userId);
+    User* editUser(const string& userId);
+    vector<Book*> parallelSearch(const string& lowerText, string (Book::*field)() const,
+                                 const string& (Book::*sortKey)() const);
 
 public:
+    // Durée d'un prêt
+    static const int LOAN_DURATION_DAYS = 14;
+
+    // En dessous de cette taille, les recherches restent sur un seul thread
+    static const size_t PARALLEL_SEARCH_THRESHOLD = 50000;
+
     // Constructor and destructor
     Library();
     ~Library() = default;
+
+    // Sort orders used by the listings
+    static bool compareByTitle(const Book* a, const Book* b);
+    static bool compareByAuthor(const Book* a, const Book* b);
+    static bool compareByTitleThenAuthor(const Book* a, const Book* b);
+    static bool compareUsersByName(const User* a, const User* b);
     
     // Book management
     void addBook(const Book& book);
+    void addBooks(vector<Book> batch);
     bool removeBook(const string& isbn);
     Book* findBookByISBN(const string& isbn);
     vector<Book*> searchBooksByTitle(const string& title);
     vector<Book*> searchBooksByAuthor(const string& author);
     vector<Book*> getAvailableBooks();
     vector<Book*> getAllBooks();
+    vector<Book*> query(const BookQuery& bookQuery);
     
     // User management
     void addUser(const User& user);
+    void addUsers(vector<User> batch);
     User* findUserById(const string& userId);
     vector<User*> getAllUsers();
+    void setUserOwner(function<Library*(const string&)> owner);
+    // User side of a loan or return whose book is in another library (shards)
+    bool borrowFor(const string& userId, const string& isbn);
+    bool returnFor(const string& userId, const string& isbn);
+    
+    // Lazy mode: records stay in the files until first looked up or scanned
+    void attachLazyRecords(unique_ptr<LazyRecordFile> bookRecords, unique_ptr<LazyRecordFile> userRecords);
+    size_t getPendingRecordCount() const;
+    void writePendingBooks(ostream& out) const;
+    void writePendingUsers(ostream& out) const;
     
     // Library operations
     bool checkOutBook(const string& isbn, const string& userId);
     bool returnBook(const string& isbn);
+
+    // Reservations
+    bool placeHold(const string& isbn, const string& userId);
+    void enqueueHold(const string& isbn, const string& userId);
+    size_t getHoldQueueDepth(const string& isbn) const;
+    size_t getTotalHolds() const;
+    vector<pair<string, vector<string>>> getAllHolds() const;
+
+    // Consistent point-in-time view for saving, exports and reports
+    LibrarySnapshot snapshot();
+    // Same, without the records still pending in lazy mode (see writePending*)
+    LibrarySnapshot decodedSnapshot() const;
+
+    // Loan history
+    EventLog& getEventLog();
+
+    // Due dates
+    vector<Book*> getOverdueBooks(time_t now = time(nullptr));
+    int getOverdueCount(time_t now = time(nullptr)) const;  // sans décoder le catalogue
+    vector<Book*> getNextDueBooks(size_t count);
     
     // Display methods
     void displayAllBooks();
     void displayAvailableBooks();
     void displayAllUsers();
     
+    // Result cache
+    void setCacheCapacity(size_t capacity);
+    size_t getCacheCapacity() const;
+    size_t getCacheHits() const;
+    size_t getCacheMisses() const;
+    size_t getCacheSize() const;
+    
     // Statistics
     int getTotalBooks() const;
+    int getTotalUsers() const;
     int getAvailableBookCount() const;
     int getCheckedOutBookCount() const;
+
+    // Memory used by each structure, in bytes (records still in the lazy
+    // files are not counted)
+    vector<pair<string, size_t>> memoryReport() const;
 };
 
 #endif
@@ -0,0 +1,46 @@
+#include "librarysnapshot.h"
+#include "radixsort.h"
+
+using namespace std;
+
+LibrarySnapshot::LibrarySnapshot(CowVector<Book> books, CowVector<User> users,
+                                 vector<pair<string, vector<string>>> holds, uint64_t generation)
+    : books(move(books)), users(move(users)), holds(move(holds)), generation(generation) {}
+
+size_t LibrarySnapshot::getBookCount() const { return books.size(); }
+size_t LibrarySnapshot::getUserCount() const { return users.size(); }
+const Book& LibrarySnapshot::getBook(size_t index) const { return *books[index]; }
+const User& LibrarySnapshot::getUser(size_t index) const { return *users[index]; }
+uint64_t LibrarySnapshot::getGeneration() const { return generation; }
+
+// Sorted by title then author, like Library::getAllBooks
+vector<const Book*> LibrarySnapshot::getAllBooks() const {
+    vector<const Book*> allBooks;
+    allBooks.reserve(books.size());
+    for (const auto& book : books) allBooks.push_back(book.get());
+    msdRadixSort(allBooks.begin(), allBooks.end(), [](const Book* book, size_t field) -> const string& {
+        return field == 0 ? book->getTitleKey() : book->getAuthorKey();
+    }, 2);
+    return allBooks;
+}
+
+// Sorted by name, like Library::getAllUsers
+vector<const User*> LibrarySnapshot::getAllUsers() const {
+    vector<const User*> allUsers;
+    allUsers.reserve(users.size());
+    for (const auto& user : users) allUsers.push_back(user.get());
+    msdRadixSort(allUsers.begin(), allUsers.end(), [](const User* user, size_t) -> const string& {
+        return user->getNameKey();
+    });
+    return allUsers;
+}
+
+const vector<pair<string, vector<string>>>& LibrarySnapshot::getAllHolds() const { return holds; }
+
+int LibrarySnapshot::getAvailableBookCount() const {
+    int available = 0;
+    for (const auto& book : books) {
+        if (book->getAvailability()) available++;
+    }
+    return available;
+}
@@ -0,0 +1,45 @@
+#ifndef LIBRARYSNAPSHOT_H
+#define LIBRARYSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "book.h"
+#include "user.h"
+#include "cowvector.h"
+
+using namespace std;
+
+// Version figée de la bibliothèque à un instant donné (voir Library::snapshot).
+// Elle partage les livres et utilisateurs avec la bibliothèque sans les
+// copier ; les emprunts et retours suivants créent de nouvelles versions des
+// fiches touchées et ne changent jamais ce que voit l'instantané. On peut donc
+// la parcourir (sauvegarde, exports, rapports), même depuis un autre thread,
+// pendant que la bibliothèque continue d'être modifiée.
+class LibrarySnapshot {
+private:
+    CowVector<Book> books;
+    CowVector<User> users;
+    vector<pair<string, vector<string>>> holds;
+    uint64_t generation;
+
+public:
+    LibrarySnapshot(CowVector<Book> books, CowVector<User> users,
+                    vector<pair<string, vector<string>>> holds, uint64_t generation);
+
+    size_t getBookCount() const;
+    size_t getUserCount() const;
+    const Book& getBook(size_t index) const;
+    const User& getUser(size_t index) const;
+    uint64_t getGeneration() const;
+
+    // Mêmes ordres que les listes de Library
+    vector<const Book*> getAllBooks() const;
+    vector<const User*> getAllUsers() const;
+    const vector<pair<string, vector<string>>>& getAllHolds() const;
+
+    int getAvailableBookCount() const;
+};
+
+#endif
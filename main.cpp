@@ -2,9 +2,12 @@
 #include <limits>
 #include <string>
 #include <algorithm>
+#include <csignal>
+#include <thread>
 
 #include "library.h"
 #include "filemanager.h"
+#include "server.h"
 
 using namespace std;
 
@@ -44,6 +47,15 @@ string getInput(const string& prompt) {
     }
 }
 
+// Reads an optional input line (may be empty)
+string getOptionalInput(const string& prompt) {
+    string input;
+    cout << prompt;
+    getline(cin, input);
+    trim(input);
+    return input;
+}
+
 // Displays the main menu
 void displayMenu() {
     cout << "\n=== SYSTÈME DE GESTION DE BIBLIOTHÈQUE PERSONNELLE ===\n";
@@ -60,19 +72,112 @@ void displayMenu() {
     cout << "11. Statistiques de la Bibliothèque\n";
     cout << "12. Sauvegarder les Données\n";
     cout << "13. Créer une Sauvegarde\n";
+    cout << "14. Recherche Combinée (Titre/Auteur/Disponibilité)\n";
+    cout << "15. Rapport des Retards\n";
+    cout << "16. Réserver un Livre\n";
+    cout << "17. Analyses des Emprunts\n";
+    cout << "18. Comparer les Formats de Stockage\n";
+    cout << "19. Exporter (CSV / JSON Lines)\n";
+    cout << "20. Importer en Lot (CSV / JSON Lines)\n";
+    cout << "21. Lister et Vérifier les Sauvegardes\n";
+    cout << "22. Restaurer une Sauvegarde\n";
     cout << "0.  Quitter\n";
     cout << "======================================================\n";
     cout << "Entrez votre choix : ";
 }
 
-int main() {
+// Prints the memory used by each structure, with the total per book
+void displayMemoryReport(const Library& library) {
+    size_t total = 0;
+    cout << "Mémoire utilisée (estimation) :\n";
+    for (const auto& line : library.memoryReport()) {
+        cout << "  " << line.first << " : " << line.second << " octets\n";
+        total += line.second;
+    }
+    cout << "  Total : " << total << " octets";
+    if (library.getTotalBooks() > 0) {
+        cout << " (" << total / static_cast<size_t>(library.getTotalBooks()) << " octets par livre)";
+    }
+    cout << "\n";
+}
+
+// Server mode: Ctrl+C stops the event loop
+static LibraryServer* activeServer = nullptr;
+
+static void stopServer(int) {
+    if (activeServer) activeServer->stop();
+}
+
+// Runs the socket server until interrupted, then saves the data
+int runServer(Library& library, FileManager& fileManager, const string& address, size_t threads) {
+    LibraryServer server(library, address, threads);
+    activeServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+
+    bool ok = server.run();
+    activeServer = nullptr;
+
+    if (ok) {
+        cout << "Sauvegarde des données...\n";
+        fileManager.saveLibraryData(library);
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     Library library;
     FileManager fileManager;
 
+    // Options :
+    //   --cache-size <n>                            taille du cache de recherches
+    //   --compact                                   catalogue binaire compact (catalog.bin)
+    //   --lazy                                      fiches décodées au premier accès
+    //   --memory-report                             affiche la mémoire par structure, puis quitte
+    //   --serve [port | unix:<chemin>] [threads]    mode serveur
+    bool serve = false;
+    bool memoryReport = false;
+    bool lazy = false;
+    string address = "5050";
+    size_t threads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        string option = argv[i];
+        if (option == "--cache-size" && i + 1 < argc) {
+            library.setCacheCapacity(static_cast<size_t>(max(0, atoi(argv[++i]))));
+        } else if (option == "--compact") {
+            fileManager.setCompactMode(true);
+        } else if (option == "--lazy") {
+            lazy = true;
+            fileManager.setLazyMode(true);
+        } else if (option == "--memory-report") {
+            memoryReport = true;
+        } else if (option == "--serve") {
+            serve = true;
+            if (i + 1 < argc) address = argv[i + 1];
+            if (i + 2 < argc) threads = static_cast<size_t>(max(1, atoi(argv[i + 2])));
+            break;
+        } else {
+            cout << "Option inconnue : " << option << "\n";
+        }
+    }
+
+    if (lazy && fileManager.isCompactMode()) {
+        cout << "Le mode paresseux ne s'applique qu'aux fichiers texte : --lazy est ignoré avec --compact.\n";
+    }
+
     // Load existing data
     cout << "Chargement des données de la bibliothèque...\n";
     fileManager.loadLibraryData(library);
 
+    if (memoryReport) {
+        displayMemoryReport(library);
+        return 0;
+    }
+
+    if (serve) {
+        return runServer(library, fileManager, address, threads);
+    }
+
     int choice;
     bool running = true;
 
@@ -256,6 +361,12 @@ int main() {
                 string isbn = getInput("Entrez l'ISBN du livre à retourner : ");
                 if (library.returnBook(isbn)) {
                     cout << "Livre retourné avec succès !\n";
+                    // remis directement au prochain dans la file de réservation ?
+                    Book* book = library.findBookByISBN(isbn);
+                    if (book && !book->getAvailability()) {
+                        cout << "Le livre a été remis à " << book->getBorrowerName()
+                             << " (" << book->getBorrowerId() << "), premier dans la file de réservation.\n";
+                    }
                 } else {
                     cout << "Erreur : Impossible de retourner le livre.\n";
                 }
@@ -268,7 +379,18 @@ int main() {
                 cout << "Total des Livres : " << library.getTotalBooks() << "\n";
                 cout << "Livres Disponibles : " << library.getAvailableBookCount() << "\n";
                 cout << "Livres Empruntés : " << library.getCheckedOutBookCount() << "\n";
-                cout << "Total des Utilisateurs : " << library.getAllUsers().size() << "\n";
+                cout << "Prêts en Retard : " << library.getOverdueCount() << "\n";
+                cout << "Total des Utilisateurs : " << library.getTotalUsers() << "\n";
+                cout << "Cache de Recherche : " << library.getCacheHits() << " succès, "
+                     << library.getCacheMisses() << " échec(s), " << library.getCacheSize()
+                     << "/" << library.getCacheCapacity() << " entrées\n";
+                cout << "Réservations en Attente : " << library.getTotalHolds() << "\n";
+                for (const auto& hold : library.getAllHolds()) {
+                    Book* book = library.findBookByISBN(hold.first);
+                    cout << "  - " << (book ? book->getTitle() : hold.first)
+                         << " : " << hold.second.size() << " en attente\n";
+                }
+                displayMemoryReport(library);
                 pauseForInput();
                 break;
             }
@@ -289,6 +411,204 @@ int main() {
                 break;
             }
 
+            case 14: { // Combined search
+                string title  = getOptionalInput("Titre contient (Entrée pour ignorer) : ");
+                string author = getOptionalInput("Auteur contient (Entrée pour ignorer) : ");
+                string dispo  = getOptionalInput("Disponibles seulement ? (o/n) : ");
+                bool availableOnly = (dispo == "o" || dispo == "O");
+
+                vector<BookQuery> predicates;
+                if (!title.empty()) predicates.push_back(BookQuery::titleContains(title));
+                if (!author.empty()) predicates.push_back(BookQuery::authorContains(author));
+                if (availableOnly) predicates.push_back(BookQuery::availableOnly());
+
+                if (predicates.empty()) {
+                    cout << "Erreur : Au moins un critère est requis.\n";
+                    pauseForInput();
+                    break;
+                }
+
+                // ET par défaut, OU si demandé (seulement utile avec plusieurs critères)
+                bool useOr = false;
+                if (predicates.size() > 1) {
+                    string mode = getOptionalInput("Combiner avec ET ou OU ? (et/ou, défaut : et) : ");
+                    transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+                    useOr = (mode == "ou");
+                }
+
+                BookQuery combined = predicates[0];
+                for (size_t i = 1; i < predicates.size(); ++i) {
+                    combined = useOr ? (combined | predicates[i]) : (combined & predicates[i]);
+                }
+
+                auto results = library.query(combined);
+                if (results.empty()) {
+                    cout << "Aucun livre ne correspond à ces critères.\n";
+                } else {
+                    cout << "\n=== RÉSULTATS DE RECHERCHE ===\n";
+                    for (size_t i = 0; i < results.size(); ++i) {
+                        cout << "\nRésultat " << (i + 1) << " :\n";
+                        cout << results[i]->toString() << "\n";
+                        cout << "-----------------------------\n";
+                    }
+                }
+                pauseForInput();
+                break;
+            }
+
+            case 15: { // Overdue report
+                time_t now = time(nullptr);
+                auto overdue = library.getOverdueBooks(now);
+
+                cout << "\n=== PRÊTS EN RETARD ===\n";
+                if (overdue.empty()) {
+                    cout << "Aucun prêt en retard.\n";
+                }
+                for (Book* book : overdue) {
+                    long joursRetard = static_cast<long>((now - book->getDueDate()) / (24 * 60 * 60));
+                    cout << "- " << book->getTitle() << " (ISBN " << book->getISBN() << ")"
+                         << " emprunté par " << book->getBorrowerName()
+                         << ", dû le " << book->getDueDateString()
+                         << " (" << joursRetard << " jour(s) de retard)\n";
+                }
+
+                cout << "\n=== PROCHAINS RETOURS ===\n";
+                auto next = library.getNextDueBooks(5);
+                if (next.empty()) {
+                    cout << "Aucun prêt en cours avec une date de retour.\n";
+                }
+                for (Book* book : next) {
+                    cout << "- " << book->getTitle() << " : " << book->getBorrowerName()
+                         << ", dû le " << book->getDueDateString() << "\n";
+                }
+                pauseForInput();
+                break;
+            }
+
+            case 16: { // Place a hold
+                string isbn = getInput("Entrez l'ISBN du livre à réserver : ");
+                string userId = getInput("Entrez l'ID de l'utilisateur : ");
+
+                Book* book = library.findBookByISBN(isbn);
+                if (book && book->getAvailability()) {
+                    cout << "Ce livre est disponible : empruntez-le directement (option 9).\n";
+                } else if (library.placeHold(isbn, userId)) {
+                    cout << "Réservation enregistrée. Position dans la file : "
+                         << library.getHoldQueueDepth(isbn) << "\n";
+                } else {
+                    cout << "Erreur : Impossible de réserver le livre. Vérifiez l'ISBN, l'ID utilisateur "
+                         << "et que l'utilisateur n'a pas déjà ce livre ou une réservation.\n";
+                }
+                pauseForInput();
+                break;
+            }
+
+            case 17: { // Loan analytics
+                EventLog& log = library.getEventLog();
+                cout << "\n=== ANALYSES DES EMPRUNTS (" << log.size() << " événements) ===\n";
+
+                cout << "\nLivres les plus empruntés :\n";
+                auto top = log.mostBorrowed(5);
+                if (top.empty()) cout << "  Aucun emprunt enregistré.\n";
+                for (size_t i = 0; i < top.size(); ++i) {
+                    Book* book = library.findBookByISBN(top[i].first);
+                    cout << "  " << (i + 1) << ". " << (book ? book->getTitle() : top[i].first)
+                         << " : " << top[i].second << " emprunt(s)\n";
+                }
+
+                cout << "\nHeures les plus achalandées :\n";
+                auto hours = log.checkoutsByHour();
+                vector<int> order(24);
+                for (int h = 0; h < 24; ++h) order[h] = h;
+                stable_sort(order.begin(), order.end(), [&hours](int a, int b) { return hours[a] > hours[b]; });
+                for (int i = 0; i < 3 && hours[order[i]] > 0; ++i) {
+                    cout << "  " << order[i] << "h - " << (order[i] + 1) << "h : "
+                         << hours[order[i]] << " emprunt(s)\n";
+                }
+
+                double jours = log.averageLoanDurationSeconds() / (24 * 60 * 60);
+                cout << "\nDurée moyenne d'un prêt : " << jours << " jour(s)\n";
+
+                string userId = getOptionalInput("\nID d'un utilisateur pour son historique (Entrée pour ignorer) : ");
+                if (!userId.empty()) {
+                    auto history = log.userHistory(userId);
+                    if (history.empty()) cout << "Aucun historique pour " << userId << ".\n";
+                    for (const auto& event : history) {
+                        char date[32];
+                        strftime(date, sizeof(date), "%Y-%m-%d %H:%M", localtime(&event.timestamp));
+                        Book* book = library.findBookByISBN(event.isbn);
+                        cout << "  " << date << "  "
+                             << (event.action == EventLog::Action::CHECKOUT ? "Emprunt " : "Retour  ")
+                             << (book ? book->getTitle() : event.isbn) << "\n";
+                    }
+                }
+                pauseForInput();
+                break;
+            }
+
+            case 18: { // Storage formats
+                cout << "\n=== FORMATS DE STOCKAGE ===\n";
+                fileManager.compareStorageFormats(library);
+                cout << "Format utilisé pour la sauvegarde : "
+                     << (fileManager.isCompactMode() ? "compact (catalog.bin)" : "texte (books.txt / users.txt)")
+                     << "\n";
+                pauseForInput();
+                break;
+            }
+
+            case 19: { // Export
+                cout << "\n=== EXPORT ===\n";
+                string type = getOptionalInput("Exporter 1) les livres, 2) les utilisateurs ou 3) les prêts ? (défaut : 1) : ");
+                CatalogExchange::Kind kind = CatalogExchange::Kind::BOOKS;
+                if (type == "2") kind = CatalogExchange::Kind::USERS;
+                if (type == "3") kind = CatalogExchange::Kind::LOANS;
+                string path = getInput("Fichier de destination (.csv ou .jsonl) : ");
+                fileManager.exportRecords(library, kind, path);
+                pauseForInput();
+                break;
+            }
+
+            case 20: { // Bulk import
+                cout << "\n=== IMPORT EN LOT ===\n";
+                string type = getOptionalInput("Importer 1) des livres ou 2) des utilisateurs ? (défaut : 1) : ");
+                CatalogExchange::Kind kind = (type == "2") ? CatalogExchange::Kind::USERS
+                                                           : CatalogExchange::Kind::BOOKS;
+                string path = getInput("Fichier à importer (.csv ou .jsonl) : ");
+                fileManager.importRecords(library, kind, path);
+                pauseForInput();
+                break;
+            }
+
+            case 21: { // List and verify backups
+                cout << "\n=== SAUVEGARDES ===\n";
+                fileManager.listBackups();
+                fileManager.verifyBackups();
+                pauseForInput();
+                break;
+            }
+
+            case 22: { // Restore a backup
+                cout << "\n=== RESTAURER UNE SAUVEGARDE ===\n";
+                fileManager.listBackups();
+                string number = getInput("Numéro de la sauvegarde à restaurer : ");
+                string confirm = getOptionalInput("Les données actuelles seront remplacées. Continuer ? (o/n) : ");
+                if (confirm != "o" && confirm != "O") {
+                    cout << "Restauration annulée.\n";
+                    pauseForInput();
+                    break;
+                }
+                int generation = atoi(number.c_str());
+                if (generation > 0 && fileManager.restoreBackup(generation)) {
+                    // quitter sans sauvegarder : la bibliothèque en mémoire écraserait la restauration
+                    cout << "Redémarrez l'application pour charger les données restaurées.\n";
+                    running = false;
+                    break;
+                }
+                if (generation <= 0) cout << "Erreur : Numéro de sauvegarde invalide.\n";
+                pauseForInput();
+                break;
+            }
+
             case 0: // Exit
                 cout << "Sauvegarde des données avant la fermeture...\n";
                 fileManager.saveLibraryData(library);
@@ -0,0 +1,42 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Estimation de la mémoire prise sur le tas par les conteneurs standards.
+// Les tailles de nœuds et de blocs de contrôle suivent libstdc++ ; l'en-tête
+// ajouté par malloc à chaque bloc (8 à 16 octets) n'est pas compté.
+
+// Bloc de contrôle d'un make_shared (vtable + deux compteurs), avant l'objet
+static const size_t SHARED_CONTROL_BYTES = sizeof(void*) + 2 * sizeof(int);
+
+// Texte d'une chaîne rangé hors de l'objet (0 pour une chaîne courte, gardée dans l'objet)
+inline size_t stringHeapBytes(const string& s) {
+    static const size_t inlineCapacity = string().capacity();
+    return s.capacity() > inlineCapacity ? s.capacity() + 1 : 0;
+}
+
+template <typename T>
+size_t vectorHeapBytes(const vector<T>& v) {
+    return v.capacity() * sizeof(T);
+}
+
+inline size_t vectorHeapBytes(const vector<string>& v) {
+    size_t bytes = v.capacity() * sizeof(string);
+    for (const string& s : v) bytes += stringHeapBytes(s);
+    return bytes;
+}
+
+// Table de hachage : tableau d'alvéoles + un nœud par entrée (suivant, valeur,
+// hachage mémorisé). Le texte des clés longues est à compter à part.
+template <typename Map>
+size_t hashTableHeapBytes(const Map& map) {
+    return map.bucket_count() * sizeof(void*) +
+           map.size() * (sizeof(void*) + sizeof(typename Map::value_type) + sizeof(size_t));
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef MERGESORTED_H
+#define MERGESORTED_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "threadpool.h"
+
+using namespace std;
+
+// Fusionne des séquences déjà triées placées bout à bout dans items.
+// bounds contient les débuts de chaque séquence suivis de la fin
+// (ex. {0, 10, 25, items.size()}). Fusion deux à deux : O(n log k).
+// Avec un groupe de threads, les fusions d'un même niveau sont parallèles.
+template <typename T, typename Compare>
+void mergeSortedRuns(vector<T>& items, vector<size_t> bounds, Compare compare, ThreadPool* pool = nullptr) {
+    while (bounds.size() > 2) {
+        vector<size_t> next = {0};
+        vector<function<void()>> merges;
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            if (i + 2 < bounds.size()) {
+                auto first = items.begin() + bounds[i];
+                auto middle = items.begin() + bounds[i + 1];
+                auto last = items.begin() + bounds[i + 2];
+                merges.push_back([first, middle, last, compare]() {
+                    inplace_merge(first, middle, last, compare);
+                });
+                next.push_back(bounds[i + 2]);
+            } else {
+                next.push_back(bounds[i + 1]);
+            }
+        }
+
+        if (pool && merges.size() > 1) {
+            pool->runAll(merges);
+        } else {
+            for (auto& merge : merges) merge();
+        }
+        bounds.swap(next);
+    }
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef QUERYCACHE_H
+#define QUERYCACHE_H
+
+#include <string>
+#include <list>
+#include <cstdint>
+#include <unordered_map>
+#include <mutex>
+
+#include "memoryusage.h"
+
+using namespace std;
+
+// Cache LRU borné des résultats de recherche et de liste.
+// Chaque résultat garde la génération de la bibliothèque au moment du calcul :
+// toute modification incrémente la génération, ce qui invalide d'un coup toutes
+// les entrées sans avoir à les parcourir (elles sont retirées à la lecture ou
+// poussées dehors par l'ordre LRU).
+// Le cache a son propre verrou : plusieurs lecteurs de la bibliothèque (mode
+// serveur) peuvent le consulter et le remplir en même temps.
+template <typename Value>
+class QueryCache {
+private:
+    struct Entry {
+        string key;
+        uint64_t generation;
+        Value value;
+    };
+
+    list<Entry> entries;  // la plus récente en tête
+    unordered_map<string, typename list<Entry>::iterator> lookup;
+    size_t capacity;
+    size_t hits = 0;
+    size_t misses = 0;
+    mutable mutex guard;
+
+    void evictOverflow() {
+        while (entries.size() > capacity) {
+            lookup.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+public:
+    explicit QueryCache(size_t capacity = 128) : capacity(capacity) {}
+
+    // Copie le résultat dans value s'il est encore valide pour cette génération
+    bool get(const string& key, uint64_t generation, Value& value) {
+        lock_guard<mutex> lock(guard);
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            misses++;
+            return false;
+        }
+        if (it->second->generation != generation) {
+            entries.erase(it->second);
+            lookup.erase(it);
+            misses++;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        hits++;
+        value = entries.front().value;
+        return true;
+    }
+
+    void put(const string& key, uint64_t generation, const Value& value) {
+        lock_guard<mutex> lock(guard);
+        if (capacity == 0) return;
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            entries.erase(it->second);
+            lookup.erase(it);
+        }
+        entries.push_front({key, generation, value});
+        lookup[key] = entries.begin();
+        evictOverflow();
+    }
+
+    void setCapacity(size_t newCapacity) {
+        lock_guard<mutex> lock(guard);
+        capacity = newCapacity;
+        evictOverflow();
+    }
+
+    void clear() {
+        lock_guard<mutex> lock(guard);
+        entries.clear();
+        lookup.clear();
+    }
+
+    size_t getCapacity() const { lock_guard<mutex> lock(guard); return capacity; }
+    size_t size() const { lock_guard<mutex> lock(guard); return entries.size(); }
+    size_t getHits() const { lock_guard<mutex> lock(guard); return hits; }
+    size_t getMisses() const { lock_guard<mutex> lock(guard); return misses; }
+
+    // Table, nœuds de la liste (deux pointeurs + entrée), clés et résultats
+    size_t heapBytes() const {
+        lock_guard<mutex> lock(guard);
+        size_t bytes = hashTableHeapBytes(lookup) + entries.size() * (2 * sizeof(void*) + sizeof(Entry));
+        for (const Entry& entry : entries) {
+            bytes += 2 * stringHeapBytes(entry.key) + vectorHeapBytes(entry.value);
+        }
+        return bytes;
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+
+using namespace std;
+
+// Tri par base (MSD) sur des clés binaires, par exemple les clés de
+// collation de collation.h. keyOf(item, field) retourne la clé du champ
+// field (0 à fieldCount - 1) ; l'ordre obtenu est celui des tuples de clés
+// comparés octet par octet. Chaque octet n'est lu qu'une ou deux fois, au
+// lieu d'une comparaison complète de chaînes à chaque étape de std::sort.
+// Le tri est stable ; les petits groupes passent par un tri par insertion.
+// Un préfixe commun est parcouru en boucle, et la récursion est bornée :
+// des titres longs et identiques ne peuvent pas épuiser la pile.
+namespace radixsort_detail {
+
+const size_t INSERTION_THRESHOLD = 32;
+const size_t MAX_LEVELS = 64;           // partages imbriqués avant stable_sort
+const size_t COUNTERS_PER_LEVEL = 2 * 258;
+
+// Compare a and b starting at byte depth of field (earlier bytes are equal)
+template <typename T, typename KeyOf>
+bool lessFrom(const T& a, const T& b, KeyOf& keyOf, size_t field, size_t depth, size_t fieldCount) {
+    for (; field < fieldCount; ++field, depth = 0) {
+        const string& ka = keyOf(a, field);
+        const string& kb = keyOf(b, field);
+        int result = ka.compare(depth, string::npos, kb, depth, string::npos);
+        if (result != 0) return result < 0;
+    }
+    return false;
+}
+
+template <typename T, typename KeyOf>
+void insertionSort(T* items, size_t n, KeyOf& keyOf, size_t field, size_t depth, size_t fieldCount) {
+    for (size_t i = 1; i < n; ++i) {
+        T value = items[i];
+        size_t j = i;
+        while (j > 0 && lessFrom(value, items[j - 1], keyOf, field, depth, fieldCount)) {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = value;
+    }
+}
+
+// counters : 2 * 258 compteurs par niveau de récursion, alloués une fois par
+// msdRadixSort (rien de gros sur la pile). level compte les partages
+// effectifs ; au-delà de MAX_LEVELS, on finit avec stable_sort.
+template <typename T, typename KeyOf>
+void sortRange(T* items, T* buffer, size_t n, KeyOf& keyOf, size_t field, size_t depth, size_t fieldCount,
+               size_t* counters, size_t level) {
+    // seau 0 : clé épuisée pour ce champ (plus courte, donc avant les autres)
+    auto bucketOf = [&](const T& item) -> size_t {
+        const string& key = keyOf(item, field);
+        return depth < key.size() ? static_cast<unsigned char>(key[depth]) + 1 : 0;
+    };
+
+    size_t* starts = counters + level * COUNTERS_PER_LEVEL;
+    size_t* next = starts + 258;
+
+    while (true) {
+        if (n < 2) return;
+        if (n < INSERTION_THRESHOLD) {
+            insertionSort(items, n, keyOf, field, depth, fieldCount);
+            return;
+        }
+        if (level >= MAX_LEVELS) {
+            stable_sort(items, items + n, [&](const T& a, const T& b) {
+                return lessFrom(a, b, keyOf, field, depth, fieldCount);
+            });
+            return;
+        }
+
+        fill(starts, starts + 258, 0);
+        for (size_t i = 0; i < n; ++i) starts[bucketOf(items[i]) + 1]++;
+
+        // tous dans le même seau (préfixe commun, clés identiques) : on avance
+        // d'un octet ou d'un champ sans déplacer les éléments ni récurser
+        size_t single = 257;
+        for (size_t b = 0; b < 257; ++b) {
+            if (starts[b + 1] == n) single = b;
+        }
+        if (single == 0) {
+            if (field + 1 >= fieldCount) return;
+            field++;
+            depth = 0;
+            continue;
+        }
+        if (single < 257) {
+            depth++;
+            continue;
+        }
+
+        for (size_t b = 1; b < 258; ++b) starts[b] += starts[b - 1];
+        for (size_t b = 0; b < 257; ++b) next[b] = starts[b];
+        for (size_t i = 0; i < n; ++i) buffer[next[bucketOf(items[i])]++] = items[i];
+        for (size_t i = 0; i < n; ++i) items[i] = buffer[i];
+
+        if (field + 1 < fieldCount) {
+            sortRange(items, buffer, starts[1], keyOf, field + 1, 0, fieldCount, counters, level + 1);
+        }
+        for (size_t b = 1; b < 257; ++b) {
+            size_t count = starts[b + 1] - starts[b];
+            sortRange(items + starts[b], buffer + starts[b], count, keyOf, field, depth + 1, fieldCount,
+                      counters, level + 1);
+        }
+        return;
+    }
+}
+
+} // namespace radixsort_detail
+
+template <typename RandomIt, typename KeyOf>
+void msdRadixSort(RandomIt first, RandomIt last, KeyOf keyOf, size_t fieldCount = 1) {
+    using T = typename iterator_traits<RandomIt>::value_type;
+    size_t n = static_cast<size_t>(last - first);
+    if (n < 2 || fieldCount == 0) return;
+
+    vector<T> buffer(n);
+    vector<size_t> counters(radixsort_detail::MAX_LEVELS * radixsort_detail::COUNTERS_PER_LEVEL);
+    radixsort_detail::sortRange(&*first, buffer.data(), n, keyOf, 0, 0, fieldCount, counters.data(), 0);
+}
+
+#endif
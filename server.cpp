@@ -0,0 +1,418 @@
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+#include "server.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+using namespace std;
+
+static const uint64_t LISTEN_ID = 0;
+static const uint64_t WAKE_ID = UINT64_MAX;
+
+// Au-delà, une requête sans fin de ligne ferme la connexion
+static const size_t MAX_LINE_LENGTH = 64 * 1024;
+
+// Au-delà, on cesse de lire un client tant qu'il ne lit pas ses réponses
+static const size_t MAX_PENDING_LINES = 1024;
+static const size_t MAX_OUTPUT_BYTES = 1024 * 1024;
+
+// Constructor
+LibraryServer::LibraryServer(Library& library, const string& address, size_t workerCount)
+    : library(library), pool(make_unique<ThreadPool>(workerCount)), address(address) {}
+
+LibraryServer::~LibraryServer() {
+    pool.reset(); // attendre les lots en cours avant de fermer les descripteurs
+#ifdef __linux__
+    for (auto& entry : connections) close(entry.second.fd);
+    if (listenFd >= 0) close(listenFd);
+    if (epollFd >= 0) close(epollFd);
+    if (wakeFd >= 0) close(wakeFd);
+    if (address.rfind("unix:", 0) == 0) unlink(address.substr(5).c_str());
+#endif
+}
+
+void LibraryServer::stop() { running = false; }
+
+// ---- Protocole ----
+
+static string bookLine(const Book* book) {
+    return book->getISBN() + "|" + book->getTitle() + "|" + book->getAuthor() + "|" +
+           (book->getAvailability() ? "1" : "0");
+}
+
+string LibraryServer::handleRequest(const string& line, bool& quit) {
+    istringstream in(line);
+    string command;
+    in >> command;
+    transform(command.begin(), command.end(), command.begin(), ::toupper);
+    quit = false;
+
+    if (command == "PING") return "OK PONG\n";
+    if (command == "QUIT") {
+        quit = true;
+        return "OK BYE\n";
+    }
+
+    // lecture : verrou partagé, sauf s'il reste des fiches à décoder
+    if (command == "LOOKUP" || command == "SEARCH" || command == "STATS") {
+        shared_lock<shared_mutex> lock(libraryMutex);
+        if (library.getPendingRecordCount() == 0) return execute(command, in);
+    }
+    unique_lock<shared_mutex> lock(libraryMutex);
+    return execute(command, in);
+}
+
+// Run a command; the caller holds the library lock
+string LibraryServer::execute(const string& command, istringstream& in) {
+    if (command == "LOOKUP") {
+        string isbn;
+        in >> isbn;
+        Book* book = library.findBookByISBN(isbn);
+        return book ? "OK " + bookLine(book) + "\n" : "ERR livre introuvable\n";
+    }
+
+    if (command == "SEARCH") {
+        string field, text;
+        in >> field;
+        getline(in >> ws, text);
+        transform(field.begin(), field.end(), field.begin(), ::toupper);
+
+        vector<Book*> results;
+        if (field == "TITLE") {
+            results = library.searchBooksByTitle(text);
+        } else if (field == "AUTHOR") {
+            results = library.searchBooksByAuthor(text);
+        } else {
+            return "ERR champ de recherche inconnu (TITLE ou AUTHOR)\n";
+        }
+
+        string response = "OK " + to_string(results.size()) + "\n";
+        for (Book* book : results) response += bookLine(book) + "\n";
+        return response;
+    }
+
+    if (command == "CHECKOUT") {
+        string isbn, userId;
+        in >> isbn >> userId;
+        return library.checkOutBook(isbn, userId) ? "OK\n" : "ERR emprunt impossible\n";
+    }
+
+    if (command == "RETURN") {
+        string isbn;
+        in >> isbn;
+        return library.returnBook(isbn) ? "OK\n" : "ERR retour impossible\n";
+    }
+
+    if (command == "STATS") {
+        return "OK total=" + to_string(library.getTotalBooks()) +
+               " available=" + to_string(library.getAvailableBookCount()) +
+               " checkedout=" + to_string(library.getCheckedOutBookCount()) +
+               " users=" + to_string(library.getTotalUsers()) + "\n";
+    }
+
+    return "ERR commande inconnue\n";
+}
+
+#ifdef __linux__
+
+// ---- Boucle epoll ----
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// "unix:<chemin>" pour une socket Unix, sinon un port TCP sur 127.0.0.1.
+// error distingue une adresse mal écrite d'un appel système refusé.
+bool LibraryServer::openListener(string& error) {
+    auto systemError = [&error](const char* call) {
+        error = string(call) + " : " + strerror(errno);
+        return false;
+    };
+
+    if (address.rfind("unix:", 0) == 0) {
+        string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            error = "chemin de socket vide ou trop long (" + to_string(sizeof(addr.sun_path) - 1) + " caractères au plus)";
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0) return systemError("socket");
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return systemError("bind");
+    } else {
+        char* rest = nullptr;
+        long port = strtol(address.c_str(), &rest, 10);
+        if (address.empty() || *rest != '\0' || port <= 0 || port > 65535) {
+            error = "port invalide (1 à 65535, ou unix:<chemin>)";
+            return false;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        if (listenFd < 0) return systemError("socket");
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return systemError("bind");
+    }
+    if (listen(listenFd, SOMAXCONN) != 0) return systemError("listen");
+    if (!setNonBlocking(listenFd)) return systemError("fcntl");
+    return true;
+}
+
+bool LibraryServer::run() {
+    string error;
+    if (!openListener(error)) {
+        cerr << "Erreur : Impossible d'écouter sur " << address << " : " << error << "\n";
+        return false;
+    }
+
+    epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        cerr << "Erreur : Impossible de démarrer le serveur : epoll_create1 : " << strerror(errno) << "\n";
+        return false;
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (wakeFd < 0) {
+        cerr << "Erreur : Impossible de démarrer le serveur : eventfd : " << strerror(errno) << "\n";
+        return false;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.u64 = WAKE_ID;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    cout << "Serveur en écoute sur " << address << " (" << pool->size() << " threads).\n";
+    running = true;
+
+    vector<epoll_event> events(256);
+    while (running) {
+        // délai court pour remarquer stop() (signal)
+        int n = epoll_wait(epollFd, events.data(), events.size(), 200);
+        if (n < 0 && errno != EINTR) break;
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == LISTEN_ID) {
+                acceptConnections();
+            } else if (id == WAKE_ID) {
+                uint64_t value;
+                while (read(wakeFd, &value, sizeof(value)) > 0) {
+                }
+                drainCompletions();
+            } else {
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readFrom(id);
+                if ((events[i].events & EPOLLOUT) && connections.count(id)) writeTo(id);
+            }
+        }
+    }
+
+    cout << "Arrêt du serveur.\n";
+    return true;
+}
+
+void LibraryServer::acceptConnections() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return; // EAGAIN : plus de connexions en attente
+        setNonBlocking(fd);
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // ignoré pour les sockets Unix
+
+        uint64_t id = nextConnectionId++;
+        connections[id].fd = fd;
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void LibraryServer::readFrom(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& conn = it->second;
+
+    if (conn.inputClosed) {
+        closeConnection(id); // HUP / erreur après la fin de l'envoi du client
+        return;
+    }
+
+    char buffer[16384];
+    while (!isSaturated(conn)) {
+        ssize_t n = read(conn.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            conn.input.append(buffer, n);
+            splitLines(conn);
+            if (conn.input.size() > MAX_LINE_LENGTH) {
+                closeConnection(id); // ligne trop longue : client fautif
+                return;
+            }
+        } else if (n == 0) {
+            // le client a fini d'envoyer : répondre à ce qui reste, puis fermer
+            conn.inputClosed = true;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            closeConnection(id);
+            return;
+        }
+    }
+
+    dispatch(id);
+    if (conn.inputClosed) {
+        writeTo(id);
+    } else if (isSaturated(conn)) {
+        updateInterest(id); // le reste attend dans le socket
+    }
+}
+
+// Too much queued for this client: stop reading it until it catches up
+bool LibraryServer::isSaturated(const Connection& conn) {
+    return conn.pending.size() >= MAX_PENDING_LINES || conn.output.size() >= MAX_OUTPUT_BYTES;
+}
+
+// Move the complete lines of the input buffer to the pending requests
+void LibraryServer::splitLines(Connection& conn) {
+    size_t start = 0, end;
+    while ((end = conn.input.find('\n', start)) != string::npos) {
+        string line = conn.input.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) conn.pending.push_back(move(line));
+        start = end + 1;
+    }
+    conn.input.erase(0, start);
+}
+
+// Send the pending requests of a connection to the pool as one batch;
+// a single batch per connection keeps the responses in order
+void LibraryServer::dispatch(uint64_t id) {
+    Connection& conn = connections[id];
+    if (conn.busy || conn.pending.empty() || conn.closeAfterFlush) return;
+    if (conn.output.size() >= MAX_OUTPUT_BYTES) return; // repris quand le client aura lu
+
+    bool wasSaturated = isSaturated(conn);
+    vector<string> batch(conn.pending.begin(), conn.pending.end());
+    conn.pending.clear();
+    conn.busy = true;
+    if (wasSaturated) updateInterest(id);
+
+    pool->submit([this, id, batch = move(batch)]() {
+        Completion done{id, "", false};
+        for (const string& line : batch) {
+            bool quit;
+            done.responses += handleRequest(line, quit);
+            if (quit) {
+                done.quit = true;
+                break;
+            }
+        }
+        {
+            lock_guard<mutex> lock(completedMutex);
+            completed.push_back(move(done));
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    });
+}
+
+void LibraryServer::drainCompletions() {
+    vector<Completion> ready;
+    {
+        lock_guard<mutex> lock(completedMutex);
+        ready.swap(completed);
+    }
+
+    for (Completion& done : ready) {
+        auto it = connections.find(done.connectionId);
+        if (it == connections.end()) continue; // fermée entre-temps
+        Connection& conn = it->second;
+        conn.busy = false;
+        conn.output += done.responses;
+        if (done.quit) conn.closeAfterFlush = true;
+
+        writeTo(done.connectionId);
+        if (connections.count(done.connectionId)) dispatch(done.connectionId);
+    }
+}
+
+void LibraryServer::writeTo(uint64_t id) {
+    Connection& conn = connections[id];
+    while (!conn.output.empty()) {
+        ssize_t n = write(conn.fd, conn.output.data(), conn.output.size());
+        if (n > 0) {
+            conn.output.erase(0, n);
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConnection(id);
+            return;
+        }
+    }
+    dispatch(id); // requêtes retenues tant que la sortie était pleine
+
+    bool finished = conn.inputClosed && !conn.busy && conn.pending.empty();
+    if (conn.output.empty() && (conn.closeAfterFlush || finished)) {
+        closeConnection(id);
+        return;
+    }
+    updateInterest(id);
+}
+
+// Watch for writability only while responses are waiting, and for input
+// only while the client is not too far behind
+void LibraryServer::updateInterest(uint64_t id) {
+    Connection& conn = connections[id];
+    epoll_event ev{};
+    ev.events = 0;
+    if (!conn.inputClosed && !isSaturated(conn)) ev.events |= EPOLLIN;
+    if (!conn.output.empty()) ev.events |= EPOLLOUT;
+    ev.data.u64 = id;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+void LibraryServer::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    close(it->second.fd);
+    connections.erase(it);
+}
+
+#else
+
+// Le mode serveur utilise epoll : Linux seulement
+bool LibraryServer::run() {
+    cerr << "Erreur : Le mode serveur n'est disponible que sous Linux.\n";
+    return false;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <memory>
+#include <sstream>
+
+#include "library.h"
+#include "threadpool.h"
+
+using namespace std;
+
+// Serveur local (socket Unix ou TCP sur 127.0.0.1) pour une Library partagée.
+// Une boucle epoll gère les connexions ; les requêtes (une par ligne) sont
+// exécutées par un groupe de threads. Un client peut envoyer plusieurs
+// requêtes d'un coup (pipelining) : les réponses reviennent dans le même ordre.
+// Les lectures (LOOKUP, SEARCH, STATS) s'exécutent en parallèle sous un verrou
+// partagé ; CHECKOUT et RETURN prennent le verrou exclusif. Tant que des fiches
+// restent à décoder (mode paresseux), une lecture peut modifier la
+// bibliothèque et passe aussi par le verrou exclusif.
+//
+// Protocole :
+//   PING                       -> OK PONG
+//   LOOKUP <isbn>              -> OK <isbn>|<titre>|<auteur>|<1/0>
+//   SEARCH TITLE <texte>       -> OK <n> suivi de n lignes <isbn>|<titre>|<auteur>|<1/0>
+//   SEARCH AUTHOR <texte>      -> idem
+//   CHECKOUT <isbn> <userId>   -> OK | ERR <raison>
+//   RETURN <isbn>              -> OK | ERR <raison>
+//   STATS                      -> OK total=<n> available=<n> checkedout=<n> users=<n>
+//   QUIT                       -> OK BYE, puis fermeture
+// Une ligne de plus de 64 Kio ferme la connexion. Un client qui ne lit pas ses
+// réponses (1 Mio en attente, ou 1024 requêtes) n'est plus lu jusqu'à ce qu'il
+// rattrape son retard.
+class LibraryServer {
+private:
+    struct Connection {
+        int fd = -1;
+        string input;            // octets reçus, pas encore découpés
+        deque<string> pending;   // requêtes en attente d'exécution
+        string output;           // réponses pas encore envoyées
+        bool busy = false;       // un lot est en cours dans le pool
+        bool closeAfterFlush = false;  // QUIT reçu
+        bool inputClosed = false;      // le client a fermé son côté
+    };
+
+    struct Completion {
+        uint64_t connectionId;
+        string responses;
+        bool quit;
+    };
+
+    Library& library;
+    shared_mutex libraryMutex;
+    unique_ptr<ThreadPool> pool;
+
+    string address;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1;   // eventfd : un lot est terminé
+    atomic<bool> running{false};
+
+    uint64_t nextConnectionId = 1;
+    unordered_map<uint64_t, Connection> connections;
+
+    mutex completedMutex;
+    vector<Completion> completed;
+
+    bool openListener(string& error);
+    void acceptConnections();
+    void readFrom(uint64_t id);
+    void writeTo(uint64_t id);
+    void dispatch(uint64_t id);
+    void drainCompletions();
+    void updateInterest(uint64_t id);
+    void closeConnection(uint64_t id);
+    static void splitLines(Connection& conn);
+    static bool isSaturated(const Connection& conn);
+    string execute(const string& command, istringstream& in);
+
+public:
+    LibraryServer(Library& library, const string& address, size_t workerCount);
+    ~LibraryServer();
+
+    // Bloque jusqu'à stop() ; retourne false si le serveur n'a pas pu démarrer
+    bool run();
+    void stop();
+
+    // Exécute une requête du protocole (thread-safe)
+    string handleRequest(const string& line, bool& quit);
+};
+
+#endif
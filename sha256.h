@@ -0,0 +1,31 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Empreinte SHA-256 (FIPS 180-4), calculée par morceaux
+class Sha256 {
+private:
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t blockLength = 0;
+    uint64_t totalLength = 0;
+
+    void compress(const uint8_t* data);
+
+public:
+    Sha256();
+
+    void update(const void* data, size_t length);
+
+    // Termine le calcul : 64 caractères hexadécimaux
+    string hexDigest();
+
+    static string hash(const void* data, size_t length);
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <future>
+
+#include "shardedlibrary.h"
+#include "mergesorted.h"
+
+using namespace std;
+
+// Constructor: every shard reads and changes users through their owning shard
+ShardedLibrary::ShardedLibrary(size_t shardCount) {
+    shardCount = max<size_t>(shardCount, 1);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(make_unique<Library>());
+    }
+    for (auto& shard : shards) {
+        shard->setUserOwner([this](const string& userId) { return shards[shardForUser(userId)].get(); });
+    }
+}
+
+// FNV-1a 64 bits : stable d'une exécution à l'autre (les fichiers en dépendent).
+// Les bits faibles de FNV-1a ne dépendent que des bits faibles de chaque
+// octet : un brassage final (celui de MurmurHash3) est nécessaire avant le modulo.
+uint64_t ShardedLibrary::hashKey(const string& key) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+size_t ShardedLibrary::getShardCount() const { return shards.size(); }
+Library& ShardedLibrary::getShard(size_t index) { return *shards[index]; }
+size_t ShardedLibrary::shardForBook(const string& isbn) const { return hashKey(isbn) % shards.size(); }
+size_t ShardedLibrary::shardForUser(const string& userId) const { return hashKey(userId) % shards.size(); }
+
+// Run the query on every shard in parallel, then merge the sorted results
+template <typename T, typename Query, typename Compare>
+vector<T*> ShardedLibrary::scatterGather(Query query, Compare compare) {
+    vector<future<vector<T*>>> pending;
+    for (auto& shard : shards) {
+        Library* library = shard.get();
+        pending.push_back(async(launch::async, [library, query]() { return query(*library); }));
+    }
+
+    vector<T*> merged;
+    vector<size_t> bounds = {0};
+    for (auto& f : pending) {
+        vector<T*> part = f.get();
+        merged.insert(merged.end(), part.begin(), part.end());
+        bounds.push_back(merged.size());
+    }
+
+    mergeSortedRuns(merged, bounds, compare);
+    return merged;
+}
+
+// Book management
+void ShardedLibrary::addBook(const Book& book) {
+    shards[shardForBook(book.getISBN())]->addBook(book);
+}
+
+bool ShardedLibrary::removeBook(const string& isbn) {
+    return shards[shardForBook(isbn)]->removeBook(isbn);
+}
+
+Book* ShardedLibrary::findBookByISBN(const string& isbn) {
+    return shards[shardForBook(isbn)]->findBookByISBN(isbn);
+}
+
+vector<Book*> ShardedLibrary::searchBooksByTitle(const string& title) {
+    return scatterGather<Book>([title](Library& l) { return l.searchBooksByTitle(title); },
+                               Library::compareByTitle);
+}
+
+vector<Book*> ShardedLibrary::searchBooksByAuthor(const string& author) {
+    return scatterGather<Book>([author](Library& l) { return l.searchBooksByAuthor(author); },
+                               Library::compareByAuthor);
+}
+
+vector<Book*> ShardedLibrary::getAvailableBooks() {
+    return scatterGather<Book>([](Library& l) { return l.getAvailableBooks(); },
+                               Library::compareByTitleThenAuthor);
+}
+
+vector<Book*> ShardedLibrary::getAllBooks() {
+    return scatterGather<Book>([](Library& l) { return l.getAllBooks(); },
+                               Library::compareByTitleThenAuthor);
+}
+
+// User management
+void ShardedLibrary::addUser(const User& user) {
+    shards[shardForUser(user.getUserId())]->addUser(user);
+}
+
+User* ShardedLibrary::findUserById(const string& userId) {
+    return shards[shardForUser(userId)]->findUserById(userId);
+}
+
+vector<User*> ShardedLibrary::getAllUsers() {
+    return scatterGather<User>([](Library& l) { return l.getAllUsers(); },
+                               Library::compareUsersByName);
+}
+
+// Library operations: routed to the shard that owns the book; the borrower
+// is read and changed in its own shard (borrowFor / returnFor)
+bool ShardedLibrary::checkOutBook(const string& isbn, const string& userId) {
+    return shards[shardForBook(isbn)]->checkOutBook(isbn, userId);
+}
+
+bool ShardedLibrary::returnBook(const string& isbn) {
+    Book* book = findBookByISBN(isbn);
+    bool legacyLoan = book && !book->getAvailability() && book->getBorrowerId().empty();
+
+    if (!shards[shardForBook(isbn)]->returnBook(isbn)) return false;
+
+    // ancien prêt sans ID d'emprunteur : le retirer chez l'utilisateur, quel que soit son fragment
+    if (legacyLoan) {
+        for (User* user : getAllUsers()) {
+            if (user->hasBorrowedBook(isbn)) {
+                string userId = user->getUserId();
+                shards[shardForUser(userId)]->returnFor(userId, isbn);
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// Statistics
+int ShardedLibrary::getTotalBooks() const {
+    int total = 0;
+    for (const auto& shard : shards) total += shard->getTotalBooks();
+    return total;
+}
+
+int ShardedLibrary::getAvailableBookCount() const {
+    int total = 0;
+    for (const auto& shard : shards) total += shard->getAvailableBookCount();
+    return total;
+}
+
+int ShardedLibrary::getCheckedOutBookCount() const { return getTotalBooks() - getAvailableBookCount(); }
@@ -0,0 +1,60 @@
+#ifndef SHARDEDLIBRARY_H
+#define SHARDEDLIBRARY_H
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "library.h"
+
+using namespace std;
+
+// Bibliothèque répartie sur plusieurs fragments (Library).
+// Les livres sont placés selon le hachage de leur ISBN, les utilisateurs selon
+// le hachage de leur ID. Les opérations ponctuelles vont au fragment
+// propriétaire ; les recherches et listes interrogent tous les fragments en
+// parallèle puis fusionnent les résultats triés.
+class ShardedLibrary {
+private:
+    vector<unique_ptr<Library>> shards;
+
+    static uint64_t hashKey(const string& key);
+
+    template <typename T, typename Query, typename Compare>
+    vector<T*> scatterGather(Query query, Compare compare);
+
+public:
+    explicit ShardedLibrary(size_t shardCount = 4);
+    ShardedLibrary(const ShardedLibrary&) = delete;
+    ShardedLibrary& operator=(const ShardedLibrary&) = delete;
+
+    size_t getShardCount() const;
+    Library& getShard(size_t index);
+    size_t shardForBook(const string& isbn) const;
+    size_t shardForUser(const string& userId) const;
+
+    // Book management
+    void addBook(const Book& book);
+    bool removeBook(const string& isbn);
+    Book* findBookByISBN(const string& isbn);
+    vector<Book*> searchBooksByTitle(const string& title);
+    vector<Book*> searchBooksByAuthor(const string& author);
+    vector<Book*> getAvailableBooks();
+    vector<Book*> getAllBooks();
+
+    // User management
+    void addUser(const User& user);
+    User* findUserById(const string& userId);
+    vector<User*> getAllUsers();
+
+    // Library operations
+    bool checkOutBook(const string& isbn, const string& userId);
+    bool returnBook(const string& isbn);
+
+    // Statistics
+    int getTotalBooks() const;
+    int getAvailableBookCount() const;
+    int getCheckedOutBookCount() const;
+};
+
+#endif
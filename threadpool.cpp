@@ -0,0 +1,123 @@
+#include <algorithm>
+
+#include "threadpool.h"
+
+using namespace std;
+
+// Groupe et position du thread courant (si c'est un thread d'un groupe)
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local size_t currentIndex = 0;
+
+// Constructor: one queue and one worker per thread (at least one)
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = max<size_t>(threadCount, 1);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues.push_back(make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// Destructor: finish the queued tasks, then join the workers
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+size_t ThreadPool::size() const { return workers.size(); }
+
+// Index of the calling worker, or size() if the caller is not one of ours
+size_t ThreadPool::currentWorker() const {
+    return (currentPool == this) ? currentIndex : workers.size();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    size_t self = currentWorker();
+    size_t target = (self < queues.size()) ? self : nextQueue++ % queues.size();
+    // compté avant d'être visible : un vol ne peut pas décrémenter avant nous
+    pendingTasks++;
+    {
+        lock_guard<mutex> lock(queues[target]->queueMutex);
+        queues[target]->tasks.push_back(move(task));
+    }
+
+    // prendre le verrou évite de réveiller un thread entre son test et son attente
+    { lock_guard<mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+// Run one task: our own newest first, otherwise steal the oldest of another queue
+bool ThreadPool::tryRunOne(size_t self) {
+    function<void()> task;
+    size_t n = queues.size();
+
+    if (self < n) {
+        lock_guard<mutex> lock(queues[self]->queueMutex);
+        if (!queues[self]->tasks.empty()) {
+            task = move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+    for (size_t k = 1; !task && k <= n; ++k) {
+        WorkQueue& victim = *queues[(self + k) % n];
+        lock_guard<mutex> lock(victim.queueMutex);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+    pendingTasks--;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (tryRunOne(index)) continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() { return stopping || pendingTasks > 0; });
+        if (stopping && pendingTasks == 0) return; // arrêt demandé et plus rien à faire
+    }
+}
+
+void ThreadPool::runAll(vector<function<void()>>& tasks) {
+    mutex doneMutex;
+    condition_variable done;
+    size_t remaining = tasks.size();
+    for (auto& task : tasks) {
+        submit([&doneMutex, &done, &remaining, &task]() {
+            task();
+            lock_guard<mutex> lock(doneMutex);
+            if (--remaining == 0) done.notify_all();
+        });
+    }
+
+    // Plus rien à prendre : les tâches restantes sont déjà en cours dans
+    // d'autres threads (qui exécutent eux-mêmes leurs sous-tâches), on dort
+    size_t self = currentWorker();
+    unique_lock<mutex> lock(doneMutex);
+    while (remaining > 0) {
+        lock.unlock();
+        bool ran = tryRunOne(self);
+        lock.lock();
+        if (!ran) done.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+}
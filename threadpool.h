@@ -0,0 +1,57 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// Groupe de threads à vol de travail (work stealing).
+// Chaque thread a sa propre file : il prend ses tâches par la fin (les plus
+// récentes, encore en cache) et, quand sa file est vide, vole les plus
+// anciennes des autres files. Une tâche soumise depuis un thread du groupe va
+// dans la file de ce thread ; les autres sont réparties à tour de rôle.
+class ThreadPool {
+private:
+    struct WorkQueue {
+        mutex queueMutex;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkQueue>> queues;  // une par thread
+    vector<thread> workers;
+    atomic<size_t> pendingTasks{0};
+    atomic<size_t> nextQueue{0};
+    mutex sleepMutex;
+    condition_variable wake;
+    bool stopping = false;
+
+    void workerLoop(size_t index);
+    bool tryRunOne(size_t self);
+    size_t currentWorker() const;
+
+public:
+    explicit ThreadPool(size_t threadCount = thread::hardware_concurrency());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+    size_t size() const;
+
+    // Exécute les tâches et attend qu'elles soient toutes finies ; le thread
+    // appelant en exécute aussi pendant l'attente (pas d'interblocage si on
+    // l'appelle depuis une tâche du groupe)
+    void runAll(vector<function<void()>>& tasks);
+
+    // Groupe partagé pour les calculs en parallèle (créé au premier usage)
+    static ThreadPool& shared();
+};
+
+#endif
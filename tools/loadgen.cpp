@@ -0,0 +1,185 @@
+// Générateur de charge pour le mode serveur (bibliotheque --serve).
+// Chaque connexion envoie ses requêtes par lots (pipelining) et mesure le
+// délai de chaque réponse ; on affiche le débit et les latences extrêmes.
+//
+// Usage : bibliotheque_loadgen [port | unix:<chemin>] [connexions] [requêtes/connexion] [profondeur]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// Mélange de requêtes envoyées en boucle
+static const vector<string> REQUESTS = {
+    "LOOKUP 9782070612758",
+    "SEARCH AUTHOR hugo",
+    "STATS",
+    "LOOKUP 9782253096337",
+    "SEARCH TITLE le",
+    "PING",
+};
+
+struct ThreadResult {
+    vector<double> latenciesUs;
+    size_t errors = 0;
+    bool connected = false;
+};
+
+static int connectTo(const string& address) {
+    int fd;
+    if (address.rfind("unix:", 0) == 0) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, address.substr(5).c_str(), sizeof(addr.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(atoi(address.c_str())));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+    return fd;
+}
+
+// Lecture ligne par ligne avec tampon
+class LineReader {
+private:
+    int fd;
+    string buffer;
+    size_t pos = 0;
+
+public:
+    explicit LineReader(int fd) : fd(fd) {}
+
+    bool next(string& line) {
+        while (true) {
+            size_t end = buffer.find('\n', pos);
+            if (end != string::npos) {
+                line = buffer.substr(pos, end - pos);
+                pos = end + 1;
+                return true;
+            }
+            buffer.erase(0, pos);
+            pos = 0;
+            char chunk[16384];
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n <= 0) return false;
+            buffer.append(chunk, n);
+        }
+    }
+};
+
+static void runConnection(const string& address, size_t requestCount, size_t depth, ThreadResult& result) {
+    int fd = connectTo(address);
+    if (fd < 0) return;
+    result.connected = true;
+    result.latenciesUs.reserve(requestCount);
+
+    LineReader reader(fd);
+    size_t sent = 0;
+    string line;
+    while (sent < requestCount) {
+        size_t batch = min(depth, requestCount - sent);
+        string payload;
+        vector<size_t> kinds;
+        for (size_t i = 0; i < batch; ++i) {
+            size_t kind = (sent + i) % REQUESTS.size();
+            kinds.push_back(kind);
+            payload += REQUESTS[kind] + "\n";
+        }
+
+        auto start = Clock::now();
+        if (write(fd, payload.data(), payload.size()) != static_cast<ssize_t>(payload.size())) break;
+
+        for (size_t kind : kinds) {
+            if (!reader.next(line)) {
+                close(fd);
+                return;
+            }
+            if (line.rfind("OK", 0) != 0) {
+                result.errors++;
+            } else if (REQUESTS[kind].rfind("SEARCH", 0) == 0) {
+                // "OK <n>" suivi de n lignes
+                size_t count = stoul(line.substr(3));
+                for (size_t i = 0; i < count && reader.next(line); ++i) {
+                }
+            }
+            result.latenciesUs.push_back(chrono::duration<double, micro>(Clock::now() - start).count());
+        }
+        sent += batch;
+    }
+
+    string quit = "QUIT\n";
+    if (write(fd, quit.data(), quit.size()) > 0) reader.next(line);
+    close(fd);
+}
+
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, static_cast<size_t>(p / 100.0 * sorted.size()));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[]) {
+    string address = (argc > 1) ? argv[1] : "5050";
+    size_t connections = (argc > 2) ? max(1, atoi(argv[2])) : 8;
+    size_t requests = (argc > 3) ? max(1, atoi(argv[3])) : 20000;
+    size_t depth = (argc > 4) ? max(1, atoi(argv[4])) : 16;
+
+    cout << "Charge : " << connections << " connexion(s) x " << requests
+         << " requête(s), pipeline de " << depth << " sur " << address << "\n";
+
+    vector<ThreadResult> results(connections);
+    vector<thread> threads;
+    auto start = Clock::now();
+    for (size_t i = 0; i < connections; ++i) {
+        threads.emplace_back(runConnection, address, requests, depth, ref(results[i]));
+    }
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    vector<double> latencies;
+    size_t errors = 0, connected = 0;
+    for (const ThreadResult& r : results) {
+        latencies.insert(latencies.end(), r.latenciesUs.begin(), r.latenciesUs.end());
+        errors += r.errors;
+        connected += r.connected;
+    }
+    if (connected == 0) {
+        cerr << "Erreur : Impossible de se connecter à " << address << ".\n";
+        return 1;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    cout << "Réponses : " << latencies.size() << " (" << errors << " erreur(s)) en " << seconds << " s\n";
+    cout << "Débit : " << static_cast<long>(latencies.size() / seconds) << " requêtes/s\n";
+    cout << "Latence (µs) : p50=" << percentile(latencies, 50)
+         << " p90=" << percentile(latencies, 90)
+         << " p99=" << percentile(latencies, 99)
+         << " p99.9=" << percentile(latencies, 99.9)
+         << " max=" << (latencies.empty() ? 0 : latencies.back()) << "\n";
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Mesure de la mémoire du catalogue quand il grandit.
+// Pour chaque taille, on construit un catalogue synthétique (un livre sur dix
+// emprunté, un utilisateur pour dix livres), on lance une recherche pour que
+// l'index et le cache existent, puis on affiche le total estimé par
+// Library::memoryReport() et les octets par livre. Sous glibc, on affiche aussi
+// la mémoire réellement allouée (mallinfo2), en-têtes de malloc compris.
+//
+// Usage : bibliotheque_membench [taille maximale] (1000000 par défaut)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include "library.h"
+
+using namespace std;
+
+static size_t heapInUse() {
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static string padded(size_t value, size_t width) {
+    string text = to_string(value);
+    text.insert(0, text.size() < width ? width - text.size() : 0, '0');
+    return text;
+}
+
+// Titres et auteurs de longueurs variées : certains tiennent dans la chaîne
+// elle-même (SSO), d'autres sont alloués sur le tas
+static const vector<string> WORDS = {"Les", "Misérables", "voyage", "au", "centre", "de", "la", "Terre",
+                                     "petit", "prince", "étranger", "rouge", "noir", "peste", "comte"};
+static const vector<string> AUTHORS = {"Victor Hugo", "Jules Verne", "Albert Camus", "Stendhal",
+                                       "Antoine de Saint-Exupéry", "Alexandre Dumas", "Émile Zola"};
+
+static void fill(Library& library, size_t bookCount) {
+    vector<Book> books;
+    books.reserve(bookCount);
+    for (size_t i = 0; i < bookCount; ++i) {
+        string title = WORDS[i % WORDS.size()];
+        for (size_t w = 1; w <= i % 4; ++w) title += " " + WORDS[(i / w + w) % WORDS.size()];
+        books.emplace_back(title, AUTHORS[i % AUTHORS.size()], "978" + padded(i, 10));
+    }
+    library.addBooks(move(books));
+
+    size_t userCount = max<size_t>(1, bookCount / 10);
+    vector<User> users;
+    users.reserve(userCount);
+    for (size_t i = 0; i < userCount; ++i) {
+        users.emplace_back("Lecteur " + to_string(i), "U" + padded(i, 7));
+    }
+    library.addUsers(move(users));
+
+    for (size_t i = 0; i < bookCount; i += 10) {
+        library.checkOutBook("978" + padded(i, 10), "U" + padded((i / 10) % userCount, 7));
+    }
+    library.query(BookQuery::titleContains("prince") & BookQuery::availableOnly());
+}
+
+int main(int argc, char* argv[]) {
+    size_t maximum = argc > 1 ? static_cast<size_t>(max(1, atoi(argv[1]))) : 1000000;
+
+    cout << setw(10) << "livres" << setw(16) << "estimé" << setw(14) << "octets/livre"
+         << setw(16) << "malloc" << setw(14) << "octets/livre" << "\n";
+
+    for (size_t count = 1000; count <= maximum; count *= 10) {
+        size_t before = heapInUse();
+        auto library = make_unique<Library>();
+        fill(*library, count);
+        size_t allocated = heapInUse() - before;
+
+        size_t estimated = 0;
+        for (const auto& line : library->memoryReport()) estimated += line.second;
+
+        cout << setw(10) << count << setw(15) << estimated << setw(14) << estimated / count;
+        if (allocated > 0) {
+            cout << setw(16) << allocated << setw(14) << allocated / count;
+        }
+        cout << "\n";
+
+        if (count == maximum || count * 10 > maximum) {
+            cout << "\nDétail pour " << count << " livres :\n";
+            for (const auto& line : library->memoryReport()) {
+                cout << "  " << left << setw(36) << line.first << right << setw(14) << line.second << "\n";
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Banc d'essai de la bibliothèque répartie (ShardedLibrary).
+// On charge le même catalogue synthétique dans une Library et dans une
+// ShardedLibrary, puis on compare les temps (ajouts, recherches par ISBN,
+// recherches par titre, emprunts et retours) et on vérifie que les deux
+// donnent les mêmes résultats :
+//  - recherches : mêmes livres ;
+//  - emprunts : le livre et son emprunteur sont souvent dans deux fragments
+//    différents, la liste d'emprunts de l'utilisateur doit quand même suivre ;
+//  - sauvegarde : les fichiers books.shardN.txt / users.shardN.txt (écrits dans
+//    un dossier temporaire) sont relus dans une nouvelle ShardedLibrary.
+// Le programme retourne 1 si une vérification échoue.
+//
+// Usage : bibliotheque_shardbench [livres] [fragments] (200000 et 4 par défaut)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+
+#include "library.h"
+#include "shardedlibrary.h"
+#include "filemanager.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+namespace fs = std::filesystem;
+
+static const vector<string> WORDS = {"Les", "Misérables", "voyage", "au", "centre", "de", "la", "Terre",
+                                     "petit", "prince", "étranger", "rouge", "noir", "peste", "comte"};
+static const vector<string> AUTHORS = {"Victor Hugo", "Jules Verne", "Albert Camus", "Stendhal",
+                                       "Antoine de Saint-Exupéry", "Alexandre Dumas", "Émile Zola"};
+
+static int failures = 0;
+
+static void check(bool ok, const string& what) {
+    if (!ok) {
+        cout << "ÉCHEC : " << what << "\n";
+        failures++;
+    }
+}
+
+static string padded(size_t value, size_t width) {
+    string text = to_string(value);
+    text.insert(0, text.size() < width ? width - text.size() : 0, '0');
+    return text;
+}
+
+static string isbnOf(size_t i) { return "978" + padded(i, 10); }
+static string userIdOf(size_t i) { return "U" + padded(i, 7); }
+
+static double millisecondsSince(Clock::time_point start) {
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+static void report(const string& step, double single, double sharded) {
+    cout << "  " << left << setw(28) << step << right << fixed << setprecision(1)
+         << setw(12) << single << setw(12) << sharded << "\n";
+}
+
+static vector<string> isbnsOf(const vector<Book*>& books) {
+    vector<string> isbns;
+    for (const Book* book : books) isbns.push_back(book->getISBN());
+    sort(isbns.begin(), isbns.end());
+    return isbns;
+}
+
+// Time the same operation on both libraries
+template <typename Operation>
+static void compare(const string& step, Library& single, ShardedLibrary& sharded, Operation operation) {
+    Clock::time_point start = Clock::now();
+    operation(single);
+    double singleMs = millisecondsSince(start);
+    start = Clock::now();
+    operation(sharded);
+    report(step, singleMs, millisecondsSince(start));
+}
+
+int main(int argc, char* argv[]) {
+    size_t bookCount = argc > 1 ? static_cast<size_t>(max(10, atoi(argv[1]))) : 200000;
+    size_t shardCount = argc > 2 ? static_cast<size_t>(max(1, atoi(argv[2]))) : 4;
+    size_t userCount = max<size_t>(1, bookCount / 10);
+
+    vector<Book> books;
+    for (size_t i = 0; i < bookCount; ++i) {
+        string title = WORDS[i % WORDS.size()];
+        for (size_t w = 1; w <= i % 4; ++w) title += " " + WORDS[(i / w + w) % WORDS.size()];
+        books.emplace_back(title, AUTHORS[i % AUTHORS.size()], isbnOf(i));
+    }
+    vector<User> users;
+    for (size_t i = 0; i < userCount; ++i) users.emplace_back("Lecteur " + to_string(i), userIdOf(i));
+
+    Library single;
+    ShardedLibrary sharded(shardCount);
+    mt19937 random(42);
+
+    cout << bookCount << " livres, " << userCount << " utilisateurs, " << shardCount << " fragment(s)\n";
+    cout << "  " << left << setw(28) << "étape (ms)" << right << setw(12) << "Library" << setw(12) << "réparti" << "\n";
+
+    compare("ajouts", single, sharded, [&](auto& library) {
+        for (const Book& book : books) library.addBook(book);
+        for (const User& user : users) library.addUser(user);
+    });
+    check(single.getTotalBooks() == sharded.getTotalBooks(), "nombre de livres");
+
+    vector<string> lookups;
+    for (size_t i = 0; i < 100000; ++i) lookups.push_back(isbnOf(random() % (bookCount + bookCount / 10)));
+    size_t singleFound = 0, shardedFound = 0;
+    compare("100 000 recherches ISBN", single, sharded, [&](auto& library) {
+        size_t& found = is_same<decltype(library), Library&>::value ? singleFound : shardedFound;
+        for (const string& isbn : lookups) found += library.findBookByISBN(isbn) != nullptr;
+    });
+    check(singleFound == shardedFound, "recherches par ISBN");
+
+    vector<Book*> singleTitles, shardedTitles;
+    compare("recherches par titre", single, sharded, [&](auto& library) {
+        auto& results = is_same<decltype(library), Library&>::value ? singleTitles : shardedTitles;
+        for (const char* word : {"prince", "terre", "noir"}) {
+            vector<Book*> found = library.searchBooksByTitle(word);
+            results.insert(results.end(), found.begin(), found.end());
+        }
+    });
+    check(isbnsOf(singleTitles) == isbnsOf(shardedTitles), "recherches par titre");
+
+    // un livre sur dix emprunté, puis la moitié rendue
+    size_t crossShard = 0;
+    for (size_t i = 0; i < bookCount; i += 10) {
+        crossShard += sharded.shardForBook(isbnOf(i)) != sharded.shardForUser(userIdOf((i / 10) % userCount));
+    }
+    compare("emprunts et retours", single, sharded, [&](auto& library) {
+        for (size_t i = 0; i < bookCount; i += 10) library.checkOutBook(isbnOf(i), userIdOf((i / 10) % userCount));
+        for (size_t i = 0; i < bookCount; i += 20) library.returnBook(isbnOf(i));
+    });
+    cout << "  (" << crossShard << " emprunt(s) entre deux fragments)\n";
+    check(single.getAvailableBookCount() == sharded.getAvailableBookCount(), "livres disponibles");
+    for (size_t i = 0; i < bookCount; i += 10) {
+        User* user = sharded.findUserById(userIdOf((i / 10) % userCount));
+        bool stillOut = i % 20 != 0;
+        if (!user || user->hasBorrowedBook(isbnOf(i)) != stillOut) {
+            check(false, "liste d'emprunts de " + userIdOf((i / 10) % userCount) + " pour " + isbnOf(i));
+            break;
+        }
+    }
+
+    // sauvegarde et relecture des fragments, dans un dossier temporaire
+    fs::path previous = fs::current_path();
+    fs::path directory = fs::temp_directory_path() / ("shardbench-" + to_string(random()));
+    fs::create_directories(directory);
+    fs::current_path(directory);
+    {
+        FileManager fileManager;
+        ShardedLibrary reloaded(shardCount);
+        Clock::time_point start = Clock::now();
+        check(fileManager.saveShardedLibrary(sharded), "sauvegarde des fragments");
+        double saveMs = millisecondsSince(start);
+        start = Clock::now();
+        check(fileManager.loadShardedLibrary(reloaded), "relecture des fragments");
+        double loadMs = millisecondsSince(start);
+        cout << "  sauvegarde " << fixed << setprecision(1) << saveMs << " ms, relecture " << loadMs << " ms\n";
+
+        check(reloaded.getTotalBooks() == sharded.getTotalBooks(), "livres relus");
+        check(reloaded.getAvailableBookCount() == sharded.getAvailableBookCount(), "prêts relus");
+        check(reloaded.getAllUsers().size() == userCount, "utilisateurs relus");
+        check(reloaded.returnBook(isbnOf(10)), "retour après relecture");
+    }
+    fs::current_path(previous);
+    fs::remove_all(directory);
+
+    cout << (failures == 0 ? "Vérifications : OK\n" : "Vérifications : " + to_string(failures) + " échec(s)\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -2,23 +2,29 @@
 #include <algorithm>
 
 #include "user.h"
+#include "collation.h"
+#include "memoryusage.h"
 
 using namespace std;
 
 // Default constructor
-User::User() : name(""), userId("") {}
+User::User() : name(""), userId(""), nameKey(frenchCollationKey("")) {}
 
 // Parameterized constructor
 User::User(const string& name, const string& userId) 
-    : name(name), userId(userId) {}
+    : name(name), userId(userId), nameKey(frenchCollationKey(name)) {}
 
 // Getters
 string User::getName() const { return name; }
 string User::getUserId() const { return userId; }
 vector<string> User::getBorrowedBooks() const { return borrowedBooks; }
+const string& User::getNameKey() const { return nameKey; }
 
 // Setters
-void User::setName(const string& name) { this->name = name; }
+void User::setName(const string& name) {
+    this->name = name;
+    nameKey = frenchCollationKey(name);
+}
 void User::setUserId(const string& userId) { this->userId = userId; }
 
 // Borrow a book
@@ -78,6 +84,7 @@ void User::fromFileFormat(const string& line) {
     
     getline(ss, name, '|');
     getline(ss, userId, '|');
+    nameKey = frenchCollationKey(name);
     
     string booksStr;
     getline(ss, booksStr, '|');
@@ -91,3 +98,12 @@ void User::fromFileFormat(const string& line) {
         }
     }
 }
+
+// Memory accounting
+size_t User::heapBytes() const {
+    return stringHeapBytes(name) + stringHeapBytes(userId) + stringHeapBytes(nameKey);
+}
+
+size_t User::borrowedBooksBytes() const { return vectorHeapBytes(borrowedBooks); }
+
+size_t User::memoryUsage() const { return sizeof(User) + heapBytes() + borrowedBooksBytes(); }
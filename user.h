@@ -10,6 +10,7 @@ class User {
 private:
     string name;
     string userId;
+    string nameKey; // clé de tri (voir collation.h)
     vector<string> borrowedBooks; // Store ISBNs of borrowed books
 
 public:
@@ -21,6 +22,7 @@ public:
     string getName() const;
     string getUserId() const;
     vector<string> getBorrowedBooks() const;
+    const string& getNameKey() const;
     
     // Setters
     void setName(const string& name);
@@ -34,6 +36,11 @@ public:
     string toString() const;
     string toFileFormat() const;
     void fromFileFormat(const string& line);
+    
+    // Memory accounting
+    size_t heapBytes() const;           // nom, ID et clé de tri hors de l'objet
+    size_t borrowedBooksBytes() const;  // tampon de borrowedBooks et ses ISBN
+    size_t memoryUsage() const;         // objet + les deux précédents
 };
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Encodage varint / zigzag partagé par les formats binaires
+// (journal des emprunts, catalogue compact).
+
+inline void putVarint(string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline bool getVarint(const string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+inline void putString(string& out, const string& s) {
+    putVarint(out, s.size());
+    out += s;
+}
+
+inline bool getString(const string& in, size_t& pos, string& s) {
+    uint64_t len;
+    if (!getVarint(in, pos, len) || len > in.size() - pos) return false;
+    s.assign(in, pos, len);
+    pos += len;
+    return true;
+}
+
+#endif